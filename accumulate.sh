@@ -0,0 +1,23 @@
+#!/bin/bash
+
+# Accumulation policies across image sizes: per-thread copies vs. one shared image.
+# The same 20M random seeds at every size so only the histogram changes.
+# Copies win on small images (private, cache resident, tiny gather); atomic and
+# tile owners win once -j copies of the image no longer fit in cache or RAM.
+# Usage: accumulate.sh [threads]
+
+J=${1:-$(grep -c ^processor /proc/cpuinfo)}
+SEEDS="-simd -orbit -random20M -j$J --no-rot"
+
+mkdir -p accumulate
+cd       accumulate
+
+for size in "320 240" "1024 768" "4000 3000" "8000 6000"; do
+    for policy in "" "-atomic" "-atomic4" "-own"; do
+        echo "$size ${policy:-copies}"
+        ../bin/omp4 $SEEDS $policy -raw accumulate.data -bmp accumulate.bmp $size 1000 1 | grep "pix/s"
+    done
+    echo ""
+done
+
+cd ..
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+# Tile binned deposition (-bin) vs direct scatter, at 1024x768 and 6000x4500.
+# Uses perf for cache misses when it is available.
+
+PERF=""
+if command -v perf > /dev/null; then
+    PERF="perf stat -e cache-misses,cache-references,LLC-load-misses"
+fi
+
+mkdir -p binning
+cd       binning
+
+for size in "1024 768 1000 10" "6000 4500 1000 1"; do
+    for bin in "" "-bin"; do
+        echo -e "\n$size $bin"
+        $PERF ../bin/omp4 -simd -orbit $bin -raw binning.data --no-bmp $size
+    done
+done
+
+cd ..
@@ -23,8 +23,14 @@
     #include <stdint.h> // uint16_t uint32_t
     #include <string.h> // memset()
 // BEGIN C++11
+    #include <chrono>
+    #include <condition_variable>
+    #include <deque>
+    #include <mutex>
     #include <thread>
+    #include <vector>
     #include "util_threads.h"
+    #include "util_progress.h"
 // END C++11
 
 #ifdef _MSC_VER
@@ -41,7 +47,7 @@
     // Input parameters
     double    gnWorldMinX        = -2.102613; // WorldW = MaxX-MinX = 3.303226
     double    gnWorldMaxX        =  1.200613;
-    double    gnWorldMinY        = -1.237710; // WorldH = MaxY-MinY = 2.47742 
+    double    gnWorldMinY        = -1.237710; // WorldH = MaxY-MinY = 2.47742
     double    gnWorldMaxY        =  1.239710;
 
     int       gnMaxDepth         = 1000; // max number of iterations == # of pixels to plot per complex number
@@ -61,24 +67,202 @@
     bool      gbSaveRawGreyscale = true ;
     bool      gbRotateOutput     = true ;
     bool      gbSaveBMP          = true ;
+    int       gnRenders          =    1; // back-to-back renders in the same thread pool
 
     // Calculated/Cached
     uint32_t  gnImageArea        =    0; // image width * image height
 
     // Output
-    uint16_t *gpGreyscaleTexels  = NULL; // [ height ][ width ] 16-bit greyscale
+    uint16_t *gpGreyscaleTexels  = NULL; // [ height ][ width ] 16-bit greyscale, saturated copy of the counts for the BMP
+    uint64_t *gpCountTexels      = NULL; // [ height ][ width ] 64-bit counts: gather + per-thread spills
+    uint64_t  gnMaxCount         =    0; // brightest count; > 65535 needs a 32-bit (or 64-bit) raw
+    uint64_t  gnDeposits         =    0; // sum of the counts, orbit points that landed in the image
     uint8_t  *gpChromaticTexels  = NULL; // [ height ][ width ] 24-bit RGB
 
-    const int BUFFER_BACKSPACE   = 64;
-    char      gaBackspace[ BUFFER_BACKSPACE ];
-
     char     *gpFileNameBMP      = 0; // user over-ride default?
     char     *gpFileNameRAW      = 0; // user over-ride default?
 
+// BEGIN C++11
+    // A per-thread 16-bit counter that wraps logs its texel here: each entry is 65536 more
+    std::vector<uint32_t> gaThreadsSpill[ MAX_THREADS ];
+
+    // Seed grid of the current render, read by the scatter job
+    struct SeedGrid
+    {
+        size_t nCol; // scaled width
+        double dx  ; // world distance between columns
+        double dy  ; // world distance between rows
+        double sx  ; // world to image scale
+        double sy  ;
+    };
+
+    SeedGrid  gGrid;
+
+    // Thread pool
+    //
+    // The workers are started once and sleep between jobs, so several renders
+    // in one process don't respawn threads. A job is a range of items cut into
+    // tiles; every worker gets a contiguous run of the tiles in its own deque.
+    // A worker pops tiles from the front of its deque and, once that is empty,
+    // steals from the back of the others' so the thief takes the tiles the
+    // victim would have reached last.
+    typedef void (*PoolJob)( const int iTid, const size_t iBegin, const size_t iEnd );
+
+    struct PoolTile
+    {
+        size_t iBegin;
+        size_t iEnd  ;
+    };
+
+    struct alignas(64) PoolWorker
+    {
+        std::mutex           lock   ;
+        std::deque<PoolTile> tiles  ; // owner pops the front, thieves the back
+        uint64_t             nTiles ; // tiles run by this worker, stolen ones included
+        uint64_t             nStolen;
+    };
+
+    PoolWorker               gaPoolWorkers[ MAX_THREADS ];
+    std::thread              gaPoolThreads[ MAX_THREADS ];
+    int                      gnPoolThreads = 0;
+
+    std::mutex               gPoolMutex;
+    std::condition_variable  gPoolWake ; // main -> workers: new job, or quit
+    std::condition_variable  gPoolIdle ; // workers -> main: job done
+    PoolJob                  gPoolJob  = NULL;
+    uint64_t                 gnPoolJobs = 0; // jobs posted so far
+    int                      gnPoolBusy = 0; // workers still on the current job
+    bool                     gbPoolQuit = false;
+// END C++11
+
+
 
 // Timer___________________________________________________________________________ 
 
-// Implementation _________________________________________________________________ 
+#ifdef _WIN32 // MSC_VER
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h> // Windows.h -> WinDef.h defines min() max()
+
+    /*
+        typedef uint16_t WORD ;
+        typedef uint32_t DWORD;
+
+        typedef struct _FILETIME {
+            DWORD dwLowDateTime;
+            DWORD dwHighDateTime;
+        } FILETIME;
+
+        typedef struct _SYSTEMTIME {
+              WORD wYear;
+              WORD wMonth;
+              WORD wDayOfWeek;
+              WORD wDay;
+              WORD wHour;
+              WORD wMinute;
+              WORD wSecond;
+              WORD wMilliseconds;
+        } SYSTEMTIME, *PSYSTEMTIME;
+    */
+
+    // *sigh* Microsoft has this in winsock2.h because they are too lazy to put it in the standard location ... !?!?
+    typedef struct timeval {
+        long tv_sec;
+        long tv_usec;
+    } timeval;
+
+    // *sigh* no gettimeofday on Win32/Win64
+    int gettimeofday(struct timeval * tp, struct timezone * tzp)
+    {
+        // FILETIME Jan 1 1970 00:00:00
+        // Note: some broken versions only have 8 trailing zero's, the correct epoch has 9 trailing zero's
+        static const uint64_t EPOCH = ((uint64_t) 116444736000000000ULL); 
+
+        SYSTEMTIME  nSystemTime;
+        FILETIME    nFileTime;
+        uint64_t    nTime;
+
+        GetSystemTime( &nSystemTime );
+        SystemTimeToFileTime( &nSystemTime, &nFileTime );
+        nTime =  ((uint64_t)nFileTime.dwLowDateTime )      ;
+        nTime += ((uint64_t)nFileTime.dwHighDateTime) << 32;
+
+        tp->tv_sec  = (long) ((nTime - EPOCH) / 10000000L);
+        tp->tv_usec = (long) (nSystemTime.wMilliseconds * 1000);
+        return 0;
+    }
+#else
+    #include <sys/time.h>
+#endif // _WIN32
+
+    struct DataRate
+    {
+        char     prefix ;
+        uint64_t samples;
+        uint64_t per_sec;
+    };
+
+    class Timer
+    {
+        timeval start, end; // Windows: winsock2.h  Unix: sys/time.h 
+    public:
+        double   elapsed; // total seconds
+        uint8_t  secs;
+        uint8_t  mins;
+        uint8_t  hour;
+        uint32_t days;
+
+        DataRate throughput;
+        char     day[ 16 ]; // output
+        char     hms[ 12 ]; // output
+
+        void Start()
+        {
+            gettimeofday( &start, NULL );
+        }
+
+        void Stop()
+        {
+            gettimeofday( &end, NULL );
+            elapsed = (end.tv_sec - start.tv_sec);
+
+            size_t s = elapsed;
+            secs = s % 60; s /= 60;
+            mins = s % 60; s /= 60;
+            hour = s % 24; s /= 24;
+            days = s;
+
+            day[0] = 0;
+            if( days > 0 )
+                snprintf( day, 15, "%d day%s, ", days, (days == 1) ? "" : "s" );
+
+            sprintf( hms, "%02d:%02d:%02d", hour, mins, secs );
+        }
+
+        // size is number of bytes in a file, or number of iterations that you want to benchmark
+        void Throughput( uint64_t size )
+        {
+            const int MAX_PREFIX = 4;
+            DataRate datarate[ MAX_PREFIX ] = {
+                {' ',0,0}, {'K',0,0}, {'M',0,0}, {'G',0,0} // 1; 1,000; 1,000,000; 1,000,000,000
+            };
+
+            if( !elapsed )
+                return;
+
+            int best = 0;
+            for( int units = 0; units < MAX_PREFIX; units++ )
+            {
+                    datarate[ units ].samples = size >> (10*units);
+                    datarate[ units ].per_sec = (uint64_t) (datarate[units].samples / elapsed);
+                if (datarate[ units ].per_sec > 0)
+                    best = units;
+            }
+            throughput = datarate[ best ];
+        }
+    };
+
+// Implementation _________________________________________________________________
 
 // ========================================================================
 void AllocImageMemory( const int width, const int height )
@@ -89,15 +273,14 @@ void AllocImageMemory( const int width, const int height )
     gpGreyscaleTexels = (uint16_t*) malloc( nGreyscaleBytes );          // 1x 16-bit channel: W
     memset( gpGreyscaleTexels, 0, nGreyscaleBytes );
 
+    const size_t nCountBytes     = gnImageArea  * sizeof( uint64_t );
+    gpCountTexels     = (uint64_t*) malloc( nCountBytes );              // 1x 64-bit count
+    memset( gpCountTexels, 0, nCountBytes );
+
     const size_t chromaticBytes  = gnImageArea * 3 * sizeof( uint8_t ); // 3x 8-bit channels: R,G,B
     gpChromaticTexels = (uint8_t*) malloc( chromaticBytes );
     memset( gpChromaticTexels, 0, chromaticBytes );
 
-    for( int i = 0; i < (BUFFER_BACKSPACE-1); i++ )
-        gaBackspace[ i ] = 8; // ASCII backspace
-
-    gaBackspace[ BUFFER_BACKSPACE-1 ] = 0;
-
 // BEGIN C++11
     if(!gnThreadsActive) // user didn't specify how many threads to use, default to all of them
         gnThreadsActive = gnThreadsMaximum;
@@ -113,6 +296,629 @@ void AllocImageMemory( const int width, const int height )
 }
 
 
+// ========================================================================
+void BMP_WriteColor24bit( const char * filename, const uint8_t *texelsRGB, const int width, const int height )
+{
+    uint32_t headers[13]; // 54 bytes == 13 x int32
+    FILE   * pFileSave;
+    int x, y, i;
+
+    // Stupid Windows BMP must have each scanline width padded to 4 bytes
+    int      nExtraBytes = (width * 3) % 4;
+    int      nPaddedSize = (width * 3 + nExtraBytes) * height;
+    uint32_t nPlanes     =  1      ; // 1 plane
+    uint32_t nBitcount   = 24 << 16; // 24-bit RGB; 32-bit packed for writing
+
+    // Header: Note that the "BM" identifier in bytes 0 and 1 is NOT included in these "headers".
+    headers[ 0] = nPaddedSize + 54;    // bfSize (total file size)
+    headers[ 1] = 0;                   // bfReserved1 bfReserved2
+    headers[ 2] = 54;                  // bfOffbits
+    headers[ 3] = 40;                  // biSize BITMAPHEADER
+    headers[ 4] = width;               // biWidth
+    headers[ 5] = height;              // biHeight
+    headers[ 6] = nBitcount | nPlanes; // biPlanes, biBitcount
+    headers[ 7] = 0;                   // biCompression
+    headers[ 8] = nPaddedSize;         // biSizeImage
+    headers[ 9] = 0;                   // biXPelsPerMeter
+    headers[10] = 0;                   // biYPelsPerMeter
+    headers[11] = 0;                   // biClrUsed
+    headers[12] = 0;                   // biClrImportant
+
+    pFileSave = fopen(filename, "wb");
+    if( pFileSave )
+    {
+        // Output Headers
+        fprintf(pFileSave, "BM");
+        for( i = 0; i < 13; i++ )
+        {
+           fprintf( pFileSave, "%c", ((headers[i]) >>  0) & 0xFF );
+           fprintf( pFileSave, "%c", ((headers[i]) >>  8) & 0xFF );
+           fprintf( pFileSave, "%c", ((headers[i]) >> 16) & 0xFF );
+           fprintf( pFileSave, "%c", ((headers[i]) >> 24) & 0xFF );
+        }
+
+        // Stupid Windows BMP are written upside down
+        for( y = height - 1; y >= 0; y-- )
+        {
+            const uint8_t* scanline = &texelsRGB[ y*width*3 ];
+            for( x = 0; x < width; x++ )
+            {
+                // swizzle rgb -> brg
+                uint8_t r = *scanline++;
+                uint8_t g = *scanline++;
+                uint8_t b = *scanline++;
+
+                // Stupid Windows BMP are written BGR
+                fprintf( pFileSave, "%c", b );
+                fprintf( pFileSave, "%c", g );
+                fprintf( pFileSave, "%c", r );
+           }
+
+           if( nExtraBytes ) // See above - BMP lines must be of lengths divisible by 4 bytes.
+              for( i = 0; i < nExtraBytes; i++ )
+                 fprintf( pFileSave, "%c", 0 );
+        }
+
+        fclose( pFileSave );
+    }
+}
+
+
+// Scan all pixels and return the maximum brightness
+// ========================================================================
+uint16_t
+Image_Greyscale16bitMaxValue( const uint16_t *texels, const int width, const int height )
+{
+    const uint16_t *pSrc = texels;
+    const int       nLen = width * height;
+    /* */ int       nMax = *pSrc;
+
+    for( int iPix = 0; iPix < nLen; iPix++ )
+    {
+        if( nMax < *pSrc )
+            nMax = *pSrc;
+        pSrc++;
+    }
+
+    return nMax;
+}
+
+
+// ========================================================================
+void
+Image_Greyscale16bitRotateRight( const uint16_t *input, const int width, const int height, uint16_t *output_ )
+{
+    // Source row[y] -> Dest col[ h-y-1 ]
+    //   Source   ->
+    //   0 1 2 4     5 0
+    //   5 6 7 8     6 1
+    //               7 2
+    //               8 4
+
+    // Linearized 1D memory Layout for Source and Dest
+    // [    0*w] [1] [2] .. [1w-1]
+    // [    1*w] ...........[2w-1]
+    // [    2*w] ...........[3w-1]
+    // :                         :
+    // [(h-1)*w] .........  [hw-1]
+
+    for( int y = 0; y < height; y++ )
+    {
+        const uint16_t *pSrc = input   + ((width   ) * y);
+        /* */ uint16_t *pDst = output_ + ((height-1) - y);
+
+        for( int x = 0; x < width; x++ )
+        {
+            *pDst = *pSrc;
+
+             pSrc++;
+             pDst += height;
+        }
+    }
+}
+
+
+// ========================================================================
+uint16_t
+Image_Greyscale16bitToBrightnessBias( int* bias_, float* scaleR_, float* scaleG_, float* scaleB_ )
+{
+    uint16_t nMaxBrightness = Image_Greyscale16bitMaxValue( gpGreyscaleTexels, gnWidth, gnHeight );
+
+    if( gbAutoBrightness )
+    {
+        if( nMaxBrightness < 256)
+            *bias_ = 0;
+
+        // TODO: if bright < 256 should this be adjusted?
+        *bias_ = (int)(-0.045 * nMaxBrightness); // low-pass noise filter; if greyscale pixel < bias then greyscale pixel = 0
+
+        *scaleR_ = 430.f / (float)nMaxBrightness;
+        *scaleG_ = 525.f / (float)nMaxBrightness;
+        *scaleB_ = 860.f / (float)nMaxBrightness;
+    }
+
+    return nMaxBrightness;
+}
+
+
+// @param greyscale  Source greyscale texels to read
+// @param chromatic_ Destination chromatic texels to write
+// ========================================================================
+void
+Image_Greyscale16bitToColor24bit(
+    const uint16_t* greyscale, const int width, const int height,
+    /* */ uint8_t * chromatic_,
+    const int bias, const double scaleR, const double scaleG, const double scaleB )
+{
+    const int       nLen = width * height;
+    const uint16_t *pSrc = greyscale;
+    /* */ uint8_t  *pDst = chromatic_;
+
+    for( int iPix = 0; iPix < nLen; iPix++ )
+    {
+        int i = *pSrc++ + bias  ; // low pass noise filter
+        int r = (int)(i * scaleR);
+        int g = (int)(i * scaleG);
+        int b = (int)(i * scaleB);
+
+        if (r > 255) r = 255; if (r < 0) r = 0;
+        if (g > 255) g = 255; if (g < 0) g = 0;
+        if (b > 255) b = 255; if (b < 0) b = 0;
+
+        *pDst++ = r;
+        *pDst++ = g;
+        *pDst++ = b;
+    }
+}
+
+
+// ========================================================================
+char* itoaComma( size_t n, char *output_ = NULL )
+{
+    const  size_t SIZE = 32;
+    static char   buffer[ SIZE ];
+    /* */  char  *p = buffer + SIZE-1;
+    *p-- = 0;
+
+    while( n >= 1000 )
+    {
+        *p-- = '0' + (n % 10); n /= 10;
+        *p-- = '0' + (n % 10); n /= 10;
+        *p-- = '0' + (n % 10); n /= 10;
+        *p-- = ','                    ;
+    }
+
+    /*      */ { *p-- = '0' + (n % 10); n /= 10; }
+    if( n > 0) { *p-- = '0' + (n % 10); n /= 10; }
+    if( n > 0) { *p-- = '0' + (n % 10); n /= 10; }
+
+    if( output_ )
+    {
+        char   *pEnd = buffer + SIZE - 1;
+        size_t  nLen = pEnd - p; 
+        memcpy( output_, p+1, nLen );
+    }
+
+    return ++p;
+}
+
+
+// ========================================================================
+void
+RAW_WriteGreyscale16bit( const char *filename, const uint16_t *texels, const int width, const int height )
+{
+    FILE *file = fopen( filename, "wb" );
+    if( file )
+    {
+        const size_t area = width * height;
+        fwrite( texels, sizeof( uint16_t ), area, file );
+        fclose( file );
+    }
+}
+
+
+// Write counts as 32-bit or 64-bit raw
+// ========================================================================
+void
+RAW_WriteGreyscaleWide( const char *filename, const uint64_t *texels, const int width, const int height, const int bits )
+{
+    FILE *file = fopen( filename, "wb" );
+    if( file )
+    {
+        const size_t area = width * height;
+        if( bits == 64 )
+            fwrite( texels, sizeof( uint64_t ), area, file );
+        else
+        {
+            uint32_t *pTexels = (uint32_t*) malloc( area * sizeof( uint32_t ) );
+            for( size_t iPix = 0; iPix < area; iPix++ )
+                pTexels[ iPix ] = (uint32_t) texels[ iPix ];
+            fwrite( pTexels, sizeof( uint32_t ), area, file );
+            free( pTexels );
+        }
+        fclose( file );
+    }
+}
+
+
+// BEGIN C++11
+// Next tile for worker iTid: the front of its own deque, else the back of another's
+// @return false when every deque is empty
+// ========================================================================
+bool Pool_Take( const int iTid, PoolTile *tile_ )
+{
+    PoolWorker &self = gaPoolWorkers[ iTid ];
+    {
+        std::lock_guard<std::mutex> lock( self.lock );
+        if( !self.tiles.empty() )
+        {
+            *tile_ = self.tiles.front();
+            self.tiles.pop_front();
+            self.nTiles++;
+            return true;
+        }
+    }
+
+    // Victims in turn starting with the next worker, so thieves spread out
+    for( int iVictim = 1; iVictim < gnPoolThreads; iVictim++ )
+    {
+        PoolWorker &victim = gaPoolWorkers[ (iTid + iVictim) % gnPoolThreads ];
+
+        std::lock_guard<std::mutex> lock( victim.lock );
+        if( !victim.tiles.empty() )
+        {
+            *tile_ = victim.tiles.back();
+            victim.tiles.pop_back();
+            self.nTiles++;
+            self.nStolen++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// Jobs never add tiles, so once every deque is empty the job is done
+// ========================================================================
+void Pool_Worker( const int iTid )
+{
+    uint64_t nJobs = 0; // jobs this worker has run
+
+    for(;;)
+    {
+        PoolJob job;
+        {
+            std::unique_lock<std::mutex> lock( gPoolMutex );
+            while( !gbPoolQuit && (gnPoolJobs == nJobs) )
+                gPoolWake.wait( lock );
+
+            if( gbPoolQuit )
+                return;
+
+            job   = gPoolJob;
+            nJobs = gnPoolJobs;
+        }
+
+        PoolTile tile;
+        while( Pool_Take( iTid, &tile ) )
+            job( iTid, tile.iBegin, tile.iEnd );
+
+        std::lock_guard<std::mutex> lock( gPoolMutex );
+        if( --gnPoolBusy == 0 )
+            gPoolIdle.notify_one();
+    }
+}
+
+
+// ========================================================================
+void Pool_Start( const int nThreads )
+{
+    gnPoolThreads = nThreads;
+    gbPoolQuit    = false;
+
+    for( int iThread = 0; iThread < nThreads; iThread++ )
+        gaPoolThreads[ iThread ] = std::thread( Pool_Worker, iThread );
+}
+
+
+// ========================================================================
+void Pool_Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock( gPoolMutex );
+        gbPoolQuit = true;
+    }
+    gPoolWake.notify_all();
+
+    for( int iThread = 0; iThread < gnPoolThreads; iThread++ )
+        gaPoolThreads[ iThread ].join();
+    gnPoolThreads = 0;
+}
+
+
+// Run job over items [0,nItems) in tiles of nPerTile and wait for it to finish
+// ========================================================================
+void Pool_Run( PoolJob job, const size_t nItems, const size_t nPerTile )
+{
+    const size_t nTiles = (nItems + nPerTile - 1) / nPerTile;
+
+    std::unique_lock<std::mutex> lock( gPoolMutex );
+
+    // Contiguous runs of tiles per worker: neighbouring rows share cache lines of the image
+    for( size_t iTile = 0; iTile < nTiles; iTile++ )
+    {
+        PoolTile tile;
+        tile.iBegin = iTile * nPerTile;
+        tile.iEnd   = (tile.iBegin + nPerTile < nItems) ? tile.iBegin + nPerTile : nItems;
+
+        gaPoolWorkers[ (iTile * gnPoolThreads) / nTiles ].tiles.push_back( tile );
+    }
+
+    gPoolJob   = job;
+    gnPoolBusy = gnPoolThreads;
+    gnPoolJobs++;
+    gPoolWake.notify_all();
+
+    while( gnPoolBusy )
+        gPoolIdle.wait( lock );
+}
+// END C++11
+
+
+// Per-thread counters stay 16-bit to keep their cache footprint; a counter
+// that wraps is logged in the thread's spill list and restarts at 0.
+// ========================================================================
+inline
+void deposit( uint16_t *texels, std::vector<uint32_t> &spill, const int iTexel )
+{
+    if( ++texels[ iTexel ] == 0 )
+        spill.push_back( iTexel );
+}
+
+
+// @param wx World X start location
+// @param wy World Y start location
+// @param sx World to Image scale X
+// @param sy World to Image scale Y
+// ========================================================================
+inline
+void plot( double wx, double wy, double sx, double sy, uint16_t *texels, std::vector<uint32_t> &spill, const int width, const int height, const int maxdepth )
+{
+    double  r = 0., i = 0.; // Zn   current Complex< real, imaginary >
+    double  s     , j     ; // Zn+1 next    Complex< real, imaginary >
+    int     u     , v     ; // texel coords
+
+    for( int depth = 0; depth <= maxdepth; depth++ ) // Note: <=
+    {
+        s = (r*r - i*i) + wx;
+        j = (2.0*r*i)   + wy;
+
+        r = s;
+        i = j;
+
+        // Optimizaton: We don't need to re-check since we already know
+        //   a) that this point escapes, and
+        //   b) the maxdepth
+        //if ((r*r + i*i) > 4.0 ) // escapes to infinity, don't render
+        //    return;
+
+        u = (int) ((r - gnWorldMinX) * sx); // texel x
+        v = (int) ((i - gnWorldMinY) * sy); // texel y
+
+        if( (u < width) && (v < height) && (u >= 0) && (v >= 0) )
+            deposit( texels, spill, (v * width) + u );
+    }
+}
+
+
+// 1. Scatter: the seeds of scaled rows [iRowBegin,iRowEnd)
+// ========================================================================
+void Job_Scatter( const int iTid, const size_t iRowBegin, const size_t iRowEnd )
+{
+    /* */ uint16_t              *texels = gaThreadsTexels[ iTid ];
+    /* */ std::vector<uint32_t> &spill  = gaThreadsSpill [ iTid ];
+
+    for( size_t iRow = iRowBegin; iRow < iRowEnd; iRow++ )
+    {
+        const double y = gnWorldMinY + (iRow * gGrid.dy);
+
+        for( size_t iCol = 0; iCol < gGrid.nCol; iCol++ )
+        {
+            const double x = gnWorldMinX + (iCol * gGrid.dx);
+
+            /* */ double r = 0., i = 0., s, j;
+
+            for( int depth = 0; depth < gnMaxDepth; depth++ )
+            {
+                s = (r*r - i*i) + x; // Zn+1 = Zn^2 + C<x,y>
+                j = (2.0*r*i)   + y;
+
+                r = s;
+                i = j;
+
+                if ((r*r + i*i) > 4.0) // escapes to infinity so trace path
+                {
+                    plot( x, y, gGrid.sx, gGrid.sy, texels, spill, gnWidth, gnHeight, depth );
+                    break;
+                }
+            }
+        }
+
+        Progress_Add( iTid, gGrid.nCol );
+    }
+}
+
+
+// 2. Gather: image rows [iRowBegin,iRowEnd) of every per-thread copy into the counts.
+// The copies are zeroed as they are read, ready for the next render.
+// ========================================================================
+void Job_Gather( const int iTid, const size_t iRowBegin, const size_t iRowEnd )
+{
+    const size_t iEnd = iRowEnd * gnWidth;
+
+    for( size_t iPix = iRowBegin * gnWidth; iPix < iEnd; iPix++ )
+    {
+        uint32_t nSum = 0; // 256 threads x 65535 fits
+
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+        {
+            nSum += gaThreadsTexels[ iThread ][ iPix ];
+            gaThreadsTexels[ iThread ][ iPix ] = 0;
+        }
+
+        gpCountTexels[ iPix ] = nSum;
+    }
+}
+
+
+// Spills into the counts, then the saturated 16-bit greyscale
+// ========================================================================
+void Counts_Resolve()
+{
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+    {
+        const std::vector<uint32_t> &spill = gaThreadsSpill[ iThread ];
+        for( size_t iSpill = 0; iSpill < spill.size(); iSpill++ )
+            gpCountTexels[ spill[ iSpill ] ] += 0x10000;
+
+        gaThreadsSpill[ iThread ].clear();
+    }
+
+    uint64_t nMax = 0;
+    uint64_t nSum = 0;
+
+    for( uint32_t iPix = 0; iPix < gnImageArea; iPix++ )
+    {
+        const uint64_t count = gpCountTexels[ iPix ];
+        if( nMax < count )
+            nMax = count;
+        nSum += count;
+
+        gpGreyscaleTexels[ iPix ] = (count < 0xFFFF) ? (uint16_t) count : 0xFFFF;
+    }
+
+    gnMaxCount = nMax;
+    gnDeposits = nSum;
+}
+
+
+// @return Number of input scaled pixels (Not uber total of all pixels processed)
+// ========================================================================
+uint64_t Buddhabrot()
+{
+    if( gnScale < 0)
+        gnScale = 1;
+
+    const size_t nCol = gnWidth  * gnScale ; // scaled width
+    const size_t nRow = gnHeight * gnScale ; // scaled height
+
+    const size_t nCel = nCol     * nRow    ; // scaled width  * scaled height;
+
+    const double nWorldW = gnWorldMaxX - gnWorldMinX;
+    const double nWorldH = gnWorldMaxY - gnWorldMinY;
+
+    // Map Source (world space) to Pixels (image space)
+    gGrid.sx   = (double)(gnWidth  - 1.) / nWorldW;
+    gGrid.sy   = (double)(gnHeight - 1.) / nWorldH;
+
+    gGrid.nCol = nCol;
+    gGrid.dx   = nWorldW / (nCol - 1.0);
+    gGrid.dy   = nWorldH / (nRow - 1.0);
+
+// BEGIN C++11
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+    {
+        gaPoolWorkers[ iThread ].nTiles  = 0;
+        gaPoolWorkers[ iThread ].nStolen = 0;
+    }
+
+    // 1. Scatter, one scaled row per tile
+    Progress_Start( nCel, gnThreadsActive, gbVerbose );
+        Pool_Run( Job_Scatter, nRow, 1 );
+    Progress_Stop();
+
+    VERBOSE
+    {
+        uint64_t nStolen = 0;
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+            nStolen += gaPoolWorkers[ iThread ].nStolen;
+
+        printf( "Stolen: %s", itoaComma( nStolen ) ); // itoaComma() has one buffer
+        printf( " / %s rows\n", itoaComma( nRow ) );
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+            printf( "    Thread %3d: %6llu rows, %6llu stolen\n", iThread
+                , (unsigned long long) gaPoolWorkers[ iThread ].nTiles
+                , (unsigned long long) gaPoolWorkers[ iThread ].nStolen );
+    }
+
+    // 2. Gather, 16 image rows per tile
+    Pool_Run( Job_Gather, gnHeight, 16 );
+// END C++11
+
+    Counts_Resolve();
+    return nCel;
+}
+
+
+// ========================================================================
+int Usage()
+{
+    const char *aOffOn[2] =
+    {
+         "OFF"
+        ,"ON "
+    };
+
+    const char *aSaved[2] =
+    {
+         "SKIP"
+        ,"SAVE"
+    };
+
+    printf(
+"Buddhabrot (C++11) by Michael Pohoreski\n"
+"https://github.com/Michaelangel007/buddhabrot\n"
+"Usage: [width [height [depth [scale]]]]\n"
+"\n"
+"-?       Display usage help\n"
+"-b       Use auto brightness\n"
+"-bmp foo Save .BMP as filename foo\n"
+// BEGIN C++11
+"-j#      Use this # of threads. (Default: %d)\n"
+"-n#      Render # times back-to-back in the same thread pool; saves the last\n"
+// END C++11
+"--no-bmp Don't save .BMP  (Default: %s)\n"
+"--no-raw Don't save .data (Default: %s)\n"
+"--no-rot Don't rotate BMP (Default: %s)\n"
+"-r       Rotation output bitmap 90 degrees right\n"
+"-raw foo Save raw greyscale as foo\n"
+"-v       Verbose.  Display %% complete and per-thread rows\n"
+// BEGIN C++11
+        , gnThreadsMaximum
+// END C++11
+        , aSaved[ (int) gbSaveBMP          ]
+        , aSaved[ (int) gbSaveRawGreyscale ]
+        , aOffOn[ (int) gbRotateOutput     ]
+    );
+
+    return 0;
+}
+
+
+// ========================================================================
+void Text_CopyFileName( char *buffer, const char *source, const size_t maxlen )
+{
+    size_t  nLen = strlen( source );
+
+    if( nLen >  maxlen )
+        nLen =  maxlen ;
+
+    memcpy( buffer, source, nLen );
+    buffer[ nLen ] = 0;
+}
+
+
 // ========================================================================
 int main( int nArg, char * aArg[] )
 {
@@ -122,8 +928,6 @@ int main( int nArg, char * aArg[] )
         gnThreadsMaximum = MAX_THREADS;
 // END C++11
 
-
-printf( "Auto-detect Threads: %u\n", gnThreadsMaximum );
     if ((gnThreadsMaximum <    1)
     ||  (gnThreadsMaximum > 1024))
     {
@@ -131,17 +935,186 @@ printf( "Auto-detect Threads: %u\n", gnThreadsMaximum );
         return -1;
     }
 
-// :
+    int   iArg = 0;
+
+    if( nArg > 1 )
+    {
+        while( iArg < nArg )
+        {
+            char *pArg = aArg[ iArg + 1 ];
+            if(  !pArg )
+                break;
+
+            if( pArg[0] == '-' )
+            {
+                iArg++;
+                pArg++; // point to 1st char in option
+
+                if( strcmp( pArg, "-no-bmp" ) == 0 ) // pArg is past the 1st '-'
+                    gbSaveBMP = false;
+                else
+                if( strcmp( pArg, "-no-raw" ) == 0 )
+                    gbSaveRawGreyscale = false;
+                else
+                if( strcmp( pArg, "-no-rot" ) == 0 )
+                    gbRotateOutput = false;
+                else
+                if( (*pArg == '?') || (strcmp( pArg, "-help" ) == 0) )
+                    return Usage();
+                else
+                if( *pArg == 'b' && (strcmp( pArg, "bmp") != 0) ) // -b and -bmp
+                    gbAutoBrightness = true;
+                else
+                if( strcmp( pArg, "bmp" ) == 0 )
+                {
+                    int n = iArg+1;
+                    if( n < nArg )
+                    {
+                        iArg++;
+                        pArg = aArg[ n ];
+                        gpFileNameBMP = pArg;
+                    }
+                }
+                else
+// BEGIN C++11
+                if( *pArg == 'j' )
+                {
+                    int i = atoi( pArg+1 );
+                    if( i > 0 )
+                        gnThreadsActive = i;
+                    if( gnThreadsActive > MAX_THREADS )
+                        gnThreadsActive = MAX_THREADS;
+                }
+                else
+                if( *pArg == 'n' )
+                {
+                    int i = atoi( pArg+1 );
+                    if( i > 0 )
+                        gnRenders = i;
+                }
+                else
+// END C++11
+                if( *pArg == 'r' && (strcmp( pArg, "raw") != 0) ) // -r and -raw
+                    gbRotateOutput = true;
+                else
+                if( *pArg == 'v' )
+                    gbVerbose = true;
+                else
+                if( strcmp( pArg, "raw" ) == 0 )
+                {
+                    int n = iArg+1;
+                    if( n < nArg )
+                    {
+                        iArg++;
+                        pArg = aArg[ n ];
+                        gpFileNameRAW = pArg;
+                    }
+                }
+                else
+                    printf( "Unrecognized option: %c\n", *pArg );
+            }
+            else
+                break;
+        }
+    }
+
+    // iArg is index to first non-flag
+    if ((iArg+1) < nArg) gnWidth    = atoi( aArg[iArg+1] );
+    if ((iArg+2) < nArg) gnHeight   = atoi( aArg[iArg+2] );
+    if ((iArg+3) < nArg) gnMaxDepth = atoi( aArg[iArg+3] );
+    if ((iArg+4) < nArg) gnScale    = atoi( aArg[iArg+4] );
 
     printf( "Width: %d  Height: %d  Depth: %d  Scale: %d  RotateBMP: %d  SaveRaw: %d\n", gnWidth, gnHeight, gnMaxDepth, gnScale, gbRotateOutput, gbSaveRawGreyscale );
 
     AllocImageMemory( gnWidth, gnHeight );
 
 // BEGIN C++11
-    printf( "Using: %u / %u cores\n", gnThreadsActive, gnThreadsMaximum );
+    printf( "Using: %u / %u threads\n", gnThreadsActive, gnThreadsMaximum );
+    Pool_Start( gnThreadsActive );
 // END C++11
 
-    return 0;
-}
+    uint64_t nCells = 0;
+    for( int iRender = 0; iRender < gnRenders; iRender++ )
+    {
+        if( gnRenders > 1 )
+            printf( "Render %d / %d\n", iRender + 1, gnRenders );
+
+        Timer stopwatch;
+        stopwatch.Start();
+            const std::chrono::steady_clock::time_point nBegin = std::chrono::steady_clock::now();
+            nCells = Buddhabrot();
+            const double nElapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - nBegin ).count();
+        stopwatch.Stop();
 
+        stopwatch.Throughput( nCells ); // Calculate throughput in pixels/s
+        printf( "%d %cpix/s (%s pixels, %.f seconds = %s%s)\n"
+            , (int)stopwatch.throughput.per_sec, stopwatch.throughput.prefix
+            , itoaComma( nCells )
+            , stopwatch.elapsed
+            , stopwatch.day
+            , stopwatch.hms
+        );
+        printf( "Deposits: %s in %.2f s, %.1f M/s\n", itoaComma( gnDeposits ), nElapsed, gnDeposits / (nElapsed * 1e6) );
+    }
 
+// BEGIN C++11
+    Pool_Stop();
+// END C++11
+
+    int nMaxBrightness = Image_Greyscale16bitToBrightnessBias( &gnGreyscaleBias, &gnScaleR, &gnScaleG, &gnScaleB ); // don't need max brightness
+    printf( "Max brightness: %d\n", nMaxBrightness );
+
+    const int PATH_SIZE = 256;
+    const char *pBaseName = "c11_buddhabrot";
+    /* */ char filenameRAW[ PATH_SIZE ];
+    /* */ char filenameBMP[ PATH_SIZE ];
+
+    if( gbSaveRawGreyscale )
+    {
+        // Only use wider texels when the counts don't fit
+        const int nBits = (gnMaxCount > 0xFFFFFFFFULL) ? 64
+                        : (gnMaxCount > 0xFFFF       ) ? 32
+                        :                                16;
+
+        if( gpFileNameRAW )
+            Text_CopyFileName( filenameRAW, gpFileNameRAW, PATH_SIZE-1 );
+        else
+            sprintf( filenameRAW, "raw_%s_%dx%d_d%d_s%d_j%d.u%d.data"
+                , pBaseName, gnWidth, gnHeight, gnMaxDepth, gnScale, gnThreadsActive, nBits );
+
+        if( nBits == 16 )
+            RAW_WriteGreyscale16bit( filenameRAW, gpGreyscaleTexels, gnWidth, gnHeight );
+        else
+            RAW_WriteGreyscaleWide ( filenameRAW, gpCountTexels    , gnWidth, gnHeight, nBits );
+        printf( "Saved: %s\n", filenameRAW );
+
+        if( nBits > 16 )
+            printf( "NOTE: Brightest count %s doesn't fit in 16 bits; raw is %d-bit, BMP is saturated\n", itoaComma( gnMaxCount ), nBits );
+    }
+
+    uint16_t *pRotatedTexels = gpGreyscaleTexels; // [ height ][ width ] 16-bit greyscale pre-BMP
+    if( gbRotateOutput && gbSaveBMP )
+    {
+        const int nBytes =  gnImageArea * sizeof( uint16_t );
+        pRotatedTexels = (uint16_t*) malloc( nBytes ); // 1x 16-bit channel: W
+        Image_Greyscale16bitRotateRight( gpGreyscaleTexels, gnWidth, gnHeight, pRotatedTexels );
+
+        int t = gnWidth;
+                gnWidth = gnHeight;
+                          gnHeight = t;
+    }
+
+    if( gbSaveBMP )
+    {
+        if( gpFileNameBMP )
+            Text_CopyFileName( filenameBMP, gpFileNameBMP, PATH_SIZE-1 );
+        else
+            sprintf( filenameBMP, "%s_%dx%d_%d.bmp", pBaseName, gnWidth, gnHeight, gnMaxDepth );
+
+        Image_Greyscale16bitToColor24bit( pRotatedTexels, gnWidth, gnHeight, gpChromaticTexels, gnGreyscaleBias, gnScaleR, gnScaleG, gnScaleB );
+        BMP_WriteColor24bit( filenameBMP, gpChromaticTexels, gnWidth, gnHeight );
+        printf( "Saved: %s\n", filenameBMP );
+    }
+
+    return 0;
+}
@@ -25,6 +25,7 @@
 // BEGIN OMP
     #include <omp.h>
     #include "util_threads.h"
+    #include "util_progress.h"
 // END OMP
 
 #ifdef _MSC_VER
@@ -69,9 +70,6 @@
     uint16_t *gpGreyscaleTexels  = NULL; // [ height ][ width ] 16-bit greyscale
     uint8_t  *gpChromaticTexels  = NULL; // [ height ][ width ] 24-bit RGB
 
-    const int BUFFER_BACKSPACE   = 64;
-    char      gaBackspace[ BUFFER_BACKSPACE ];
-
     char     *gpFileNameBMP      = 0; // user over-ride default?
     char     *gpFileNameRAW      = 0; // user over-ride default?
 
@@ -217,11 +215,6 @@ void AllocImageMemory( const int width, const int height )
     gpChromaticTexels = (uint8_t*) malloc( chromaticBytes );
     memset( gpChromaticTexels, 0, chromaticBytes );
 
-    for( int i = 0; i < (BUFFER_BACKSPACE-1); i++ )
-        gaBackspace[ i ] = 8; // ASCII backspace
-
-    gaBackspace[ BUFFER_BACKSPACE-1 ] = 0;
-
 // BEGIN OMP
     if(!gnThreadsActive) // user didn't specify how many threads to use, default to all of them
         gnThreadsActive = gnThreadsMaximum;
@@ -500,7 +493,6 @@ int Buddhabrot()
     const size_t nCol = gnWidth  * gnScale ; // scaled width
     const size_t nRow = gnHeight * gnScale ; // scaled height
 
-    /* */ size_t iCel = 0                  ; // Progress status for percent compelete
     const size_t nCel = nCol     * nRow    ; // scaled width  * scaled height;
 
     const double nWorldW = gnWorldMaxX - gnWorldMinX;
@@ -513,11 +505,9 @@ int Buddhabrot()
     const double dx = nWorldW / (nCol - 1.0);
     const double dy = nWorldH / (nRow - 1.0);
 
-    char sDenominator[ 32 ];
-    itoaComma( nCel, sDenominator );
-
 // BEGIN OMP
     // 1. Scatter
+    Progress_Start( nCel, gnThreadsActive, gbVerbose );
 
     // Linearize to 1D
 #pragma omp parallel for
@@ -525,15 +515,13 @@ int Buddhabrot()
     for( size_t iPix = 0; iPix < nCel; iPix++ )
     {
 // BEGIN OMP
-#pragma omp atomic
-        iCel++;
-
         const int       iTid = omp_get_thread_num(); // Get Thread Index: 0 .. nCores-1
         /* */ uint16_t* pTex = gaThreadsTexels[ iTid ];
 // END OMP
 
-        const size_t    iCol = iCel % nCol;
-        const size_t    iRow = iCel / nCol;
+        // The seed comes from the loop index, never from the shared progress
+        const size_t    iCol = iPix % nCol;
+        const size_t    iRow = iPix / nCol;
 
         const double    x = gnWorldMinX + (iCol * dx);
         const double    y = gnWorldMinY + (iRow * dy);
@@ -555,26 +543,14 @@ int Buddhabrot()
                 }
             }
 
-        VERBOSE
 // BEGIN OMP
-        if( (iTid == 0) && ((iCel & 0xFFFF) == 0) )
+        Progress_Add( iTid, 1 );
 // END OMP
-        {
-            // We no longer need a critical section
-            // since we only allow thread 0 to print
-            {
-                const size_t n = iCel;
-                const double percent = (100.0 * n) / nCel;
-                static char  sNumerator[ 32 ];
-                itoaComma( n, sNumerator );
-
-                printf( "%6.2f%% = %s / %s%s", percent, sNumerator, sDenominator, gaBackspace );
-                fflush( stdout );
-            }
-        }
     }
 
 // BEGIN OMP
+    Progress_Stop();
+
     // 2. Gather
     const int nPix = gnWidth  * gnHeight; // Normal area
     for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
@@ -766,7 +742,6 @@ int main( int nArg, char * aArg[] )
         int nCells = Buddhabrot();
     stopwatch.Stop();
 
-    VERBOSE printf( "100.00%%\n" );
     stopwatch.Throughput( nCells ); // Calculate throughput in pixels/s
     printf( "%d %cpix/s (%d pixels, %.f seconds = %s%s)\n"
         , (int)stopwatch.throughput.per_sec, stopwatch.throughput.prefix
@@ -22,10 +22,38 @@
     #include <math.h>
     #include <stdint.h> // uint16_t uint32_t
     #include <string.h> // memset()
+    #include <limits.h> // INT_MAX
+#if !_WIN32
+    #include <unistd.h>   // sysconf()
+    #include <sys/mman.h> // mmap() madvise()
+#endif
 // BEGIN OMP
     #include <omp.h>
+    #include <atomic>   // tile ownership queues
+    #include <thread>   // std::this_thread::yield()
+    #include <algorithm> // std::upper_bound()
     #include "util_threads.h"
+    #include "util_numa.h"
+    #include "util_progress.h"
 // END OMP
+    #include "util_interior.h"
+    #include "util_random.h"
+
+// BEGIN SIMD
+    // The vector escape kernels are compiled with per-function target attributes
+    // so the default build still runs on any x86-64 and picks the widest
+    // instruction set the CPU supports at run-time.
+    // NOTE: The Makefile builds with -ffp-contract=off so that the compiler can't
+    // fuse Zn^2 + C into an FMA in one path but not the other.
+    #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        #include <immintrin.h>
+        #define SIMD_X86      1
+        #define TARGET_AVX2   __attribute__((target("avx2")))
+        #define TARGET_AVX512 __attribute__((target("avx512f")))
+    #else
+        #define SIMD_X86      0
+    #endif
+// END SIMD
 
 #ifdef _MSC_VER
     // stupid MS ignoring standards yet again
@@ -66,15 +94,417 @@
     uint32_t  gnImageArea        =    0; // image width * image height
 
     // Output
-    uint16_t *gpGreyscaleTexels  = NULL; // [ height ][ width ] 16-bit greyscale
+    uint16_t *gpGreyscaleTexels  = NULL; // [ height ][ width ] 16-bit greyscale, saturated copy of the counts for the BMP
+    uint64_t *gpCountTexels      = NULL; // [ height ][ width ] 64-bit counts: per-thread spills + gather
+    uint64_t  gnMaxCount         =    0; // brightest count; > 65535 needs a 32-bit (or 64-bit) raw
+    uint64_t  gnDeposits         =    0; // sum of the counts, orbit points that landed in the image
     uint8_t  *gpChromaticTexels  = NULL; // [ height ][ width ] 24-bit RGB
 
-    const int BUFFER_BACKSPACE   = 64;
-    char      gaBackspace[ BUFFER_BACKSPACE ];
-
     char     *gpFileNameBMP      = 0; // user over-ride default?
     char     *gpFileNameRAW      = 0; // user over-ride default?
 
+// BEGIN SIMD
+    enum EscapeEngine_e
+    {
+         ESCAPE_SCALAR = 0 // 1 seed  at a time
+        ,ESCAPE_AVX2       // 4 seeds at a time
+        ,ESCAPE_AVX512     // 8 seeds at a time
+        ,NUM_ESCAPE_ENGINES
+    };
+
+    const char *gaEscapeEngineName[ NUM_ESCAPE_ENGINES ] =
+    {
+         "scalar"
+        ,"AVX2"
+        ,"AVX-512"
+    };
+
+    int       gnEscapeEngine     = ESCAPE_SCALAR;
+// END SIMD
+
+    // Orbit cache: record each orbit during the escape test so plot() doesn't have to re-iterate it
+    bool      gbOrbitCache       = false;
+    int       gnOrbitBudgetMB    =    1; // per thread; longer orbits fall back to re-iterating
+    int       gnOrbitCapacity    =    0; // scalar: max points recorded per orbit
+    size_t    gnOrbitRing        =    1; // SIMD  : ring rows (power of 2) x 8 lanes
+    double   *gaThreadsOrbit[ MAX_THREADS ]; // NULL = orbit cache off
+
+    // Image buffers: anonymous mmap so pages are zeroed lazily, optionally 2 MB pages
+    enum HugePages_e
+    {
+         HUGE_OFF = 0
+        ,HUGE_THP     // madvise( MADV_HUGEPAGE ): transparent huge pages where the kernel can
+        ,HUGE_TLB     // MAP_HUGETLB: pages reserved in /proc/sys/vm/nr_hugepages, else THP
+        ,NUM_HUGE
+    };
+
+    const char *gaHugePagesName[ NUM_HUGE ] =
+    {
+         "OFF"
+        ,"transparent"
+        ,"explicit"
+    };
+
+    int       gnHugePages        = HUGE_OFF;
+
+    // -tiled#: the counts and per-thread copies are stored as # x # tiles so the
+    // neighbouring points of an orbit land in the same cache lines and pages.
+    // Tiles are laid out row of tiles by row of tiles; the last column and row
+    // of tiles are narrower instead of padded, so the layout has exactly
+    // width x height texels and every texel-by-texel loop works unchanged.
+    // The counts are resolved straight into the row-major greyscale image.
+    const int LAYOUT_SHIFT       = 3; // -tiled default: 8 x 8
+    int       gnLayoutShift      = 0; // 0 = row-major
+
+    // NUMA
+    int       gnPin              = PIN_NONE;
+    int       gaThreadsNode[ MAX_THREADS ]; // node the thread's buffers were first touched on
+
+    // Accumulation policy: where the deposits of each thread end up
+    enum Accumulate_e
+    {
+         ACCUMULATE_AUTO = -1 // copies if they fit in RAM, else atomic
+        ,ACCUMULATE_COPIES    // 16-bit image per thread, gathered at the end
+        ,ACCUMULATE_OWNER     // shared 64-bit image, tiles queued to the thread that owns them
+        ,ACCUMULATE_ATOMIC    // shared 64-bit image, atomic add
+        ,ACCUMULATE_BYTES     // 8-bit image per thread, saturating counters go through an overflow log
+        ,ACCUMULATE_SPARSE    // 16-bit tiles per thread, allocated on the first deposit into them
+        ,NUM_ACCUMULATE
+    };
+
+    const char *gaAccumulateName[ NUM_ACCUMULATE ] =
+    {
+         "per-thread copies"
+        ,"tile owners"
+        ,"atomic"
+        ,"8-bit per-thread copies"
+        ,"sparse tiles"
+    };
+
+    int       gnAccumulate       = ACCUMULATE_AUTO;
+    int       gnAtomicStripes    =    1; // shared images; thread t adds into stripe t % #
+    uint64_t *gaAtomicStripes[ MAX_THREADS ]; // [0] = gpCountTexels
+    uint64_t *gpStripe           = NULL; // this thread's
+// BEGIN OMP
+#pragma omp threadprivate( gpStripe )
+// END OMP
+
+    // 8-bit counters: half the cache footprint of the 16-bit copies. A counter
+    // that would pass 255 is logged and restarts at 0; a full log is added into
+    // the 64-bit counts.
+    struct Bytes
+    {
+        uint8_t  *texels; // [ height ][ width ]
+        uint64_t *aLog  ; // texel | count << 32
+        int       nLog  ;
+        uint64_t  nSpill; // entries logged, for the report
+    };
+
+    const int BYTES_LOG          = 4096; // overflow entries per thread
+    Bytes     gaThreadsBytes[ MAX_THREADS ];
+    Bytes    *gpBytes            = NULL; // this thread's
+// BEGIN OMP
+#pragma omp threadprivate( gpBytes )
+// END OMP
+
+    // Sparse tiles: a zoomed view with seeds from the whole set leaves most of
+    // each thread's copy untouched, yet a dense copy is still gathered in full.
+    // Instead each thread keeps a directory of the 64x64 tiles (same grid as
+    // -bin#) and only allocates the ones it deposits into. A thread that
+    // touches a quarter of the tiles isn't sparse after all: it moves its tiles
+    // into an ordinary dense copy and deposits there from then on.
+    struct Sparse
+    {
+        uint16_t **aTile   ; // [ tile ] NULL until the first deposit
+        uint16_t  *pool    ; // tiles are handed out in order from here, see Image_Alloc()
+        int        nTouched;
+        uint16_t  *texels  ; // dense copy once a quarter of the tiles were touched, else NULL
+    };
+
+    const int    SPARSE_PROBE      = 64; // auto: first probe is at most a SPARSE_PROBE^2 grid of seeds ...
+    const int    SPARSE_PROBE_HITS =  4; //       ... refined until it has this many orbit points per tile
+    Sparse    gaThreadsSparse[ MAX_THREADS ];
+    Sparse   *gpSparse           = NULL; // this thread's
+// BEGIN OMP
+#pragma omp threadprivate( gpSparse )
+// END OMP
+
+    // Tile binning: each thread stages its deposits and applies them one cache-resident tile at a time
+    struct Staging
+    {
+        uint64_t *aEntry ; // texel | weight << 32 | tile << 48
+        uint64_t *aSorted; // ... partitioned by tile
+        uint32_t *aStart ; // [ tiles + 1 ] partition offsets
+        uint32_t *aOwner ; // [ threads + 1 ] -own: partition offsets by owner
+        size_t    nEntry ;
+        uint16_t *texels ; // this thread's counters
+        uint64_t *stripe ; // -atomic: this thread's shared counts
+        int       iThread;
+    };
+
+    bool      gbBinning          = false;
+    int       gnBinEntries       = 32 << 10; // staged deposits per thread before a flush
+    int       gnBinTileShift     =    6;     // 64 x 64 texels = 8 KB of 16-bit counters
+    int       gnBinTilesX        =    0;
+    int       gnBinTiles         =    0;
+    Staging   gaThreadsStaging[ MAX_THREADS ];
+    Staging  *gpStaging          = NULL; // this thread's
+// BEGIN OMP
+#pragma omp threadprivate( gpStaging )
+// END OMP
+
+    // Tile ownership: one shared image instead of a copy per thread.
+    // Tile t belongs to thread t % threads. A thread ships each flush of its staged
+    // deposits as one parcel per owner; the owner adds them into the 64-bit counts.
+    struct Batch; // a flushed staging buffer, partitioned by owner
+
+    struct Parcel // one owner's share of a batch
+    {
+        Parcel   *pNext  ;
+        Batch    *pBatch ;
+        uint32_t  iBegin ;
+        uint32_t  iEnd   ;
+    };
+
+    struct Batch
+    {
+        uint64_t         *aEntry   ;
+        Parcel           *aParcel  ; // [ threads ]
+        Batch            *pNext    ; // free list
+        std::atomic<int>  nParcels ; // not yet applied; 0 = back to the producer
+        int               iProducer;
+    };
+
+    struct alignas(64) Mailbox // lock-free stacks: anyone pushes, only the owning thread takes them, all at once
+    {
+        std::atomic<Parcel*> pInbox; // parcels for the tiles this thread owns
+        std::atomic<Batch *> pFree ; // this thread's batches, returned by the last owner to apply them
+        Batch               *pSpare; // private: free batches already taken
+    };
+
+    const int OWNER_BATCHES      =    4; // per thread
+    const int OWNER_DRAIN_SEEDS  = 1024; // seeds between inbox drains, so slow seeds don't hold up the producers
+    Mailbox   gaThreadsMailbox[ MAX_THREADS ];
+    std::atomic<int> gnOwnersDone( 0 ); // producers finished
+
+    // Interior culling: skip seeds known to be inside the set
+    bool      gbCullInterior     = false;
+    int       gnCullPeriod       =    0; // > 2 also cull the bulbs of period 3 .. #
+
+    // Periodicity checking: stop iterating a seed once its orbit revisits a point
+    bool      gbPeriodic         = false;
+    int       gnPeriodExponent   =   12; // tolerance = 10^-#
+    double    gnPeriodTolerance2 =   0.; // tolerance^2
+
+    // Seed source
+    enum SeedSource_e
+    {
+         SEED_GRID = 0 // regular grid of gnScale x gnScale seeds per pixel
+        ,SEED_RANDOM   // uniform random, counter-based so independent of threads and schedule
+        ,SEED_METROPOLIS // Metropolis-Hastings chains biased toward orbits that cross the view
+        ,SEED_ADAPTIVE   // grid, thinned where a coarse escape map says seeds matter less
+        ,SEED_SOBOL      // quasi-random, low discrepancy
+        ,SEED_RESUME     // seeds an earlier run saved unescaped at its max depth
+    };
+
+    int       gnSeedSource       = SEED_GRID;
+    uint64_t  gnSamples          =    0; // SEED_RANDOM, SEED_SOBOL, SEED_METROPOLIS: 0 = same number of seeds as the grid
+    uint64_t  gnRandomKey        =    0;
+
+    // SEED_ADAPTIVE: max stride between seeds in cells that don't need them all
+    int       gnAdaptiveStride   =    0; // 0 = gnScale i.e. 1 seed per cell
+
+    // SEED_METROPOLIS: weighted deposits, [ height ][ width ] per thread
+    double   *gaThreadsWeights[ MAX_THREADS ];
+
+    // Seeds are taken from this part of the complex plane; defaults to the view.
+    // A zoomed view usually wants the whole set e.g. -domain -2 2 -2 2
+    bool      gbDomain           = false;
+    double    gnDomainMinX       = 0.;
+    double    gnDomainMaxX       = 0.;
+    double    gnDomainMinY       = 0.;
+    double    gnDomainMaxY       = 0.;
+
+    // Real axis symmetry: only iterate seeds with imaginary part >= 0 and also deposit their conjugate orbits
+    bool      gbSymmetry         = false;
+
+    // Incremental depth: an orbit that escapes before depth D1 deposits exactly the same
+    // points at any larger max depth, so only seeds still running at D1 need to be continued.
+    struct PendingSeed
+    {
+        uint64_t index ; // grid seed (row * scaled width + column) or sample #
+        double   r, i  ; // Zn at the saved depth
+        uint16_t weight; // seeds it stands for
+        uint8_t  mirror; // also deposit the conjugate orbit
+        uint8_t  pad[5];
+    };
+
+    struct PendingHeader
+    {
+        char     magic[8]; // PENDING_MAGIC
+        int32_t  width, height, scale, depth;
+        int32_t  source  ; // SEED_GRID, SEED_RANDOM or SEED_SOBOL
+        int32_t  symmetry;
+        uint64_t key, samples;
+        double   world [4];
+        double   domain[4];
+        uint64_t count   ; // PendingSeed's that follow
+    };
+
+    const char    PENDING_MAGIC[8]   = { 'B','U','D','D','P','N','D','1' };
+
+    const char   *gpFileNamePending  = 0; // -pending: save seeds still running at max depth
+    const char   *gpFileNameExtend   = 0; // -extend: resume these seeds ...
+    const char   *gpFileNameBase     = 0; //          ... and add their orbits to this raw
+    PendingSeed  *gaThreadsPending   [ MAX_THREADS ];
+    size_t        gnThreadsPending   [ MAX_THREADS ];
+    size_t        gnThreadsPendingMax[ MAX_THREADS ];
+    PendingSeed  *gaPending          = NULL; // SEED_RESUME: sorted by weight, mirror, index
+    size_t        gnPending          =    0;
+    int           gnPendingDepth     =    0; // depth they were saved at
+    int           gnPendingSource    = SEED_GRID;
+
+    // Checkpoint: the scatter runs in epochs of whole work items. After an epoch
+    // the per-thread copies are merged into the counts, and the blocks of the
+    // counts that changed are appended to the checkpoint file with the bitmap of
+    // finished work items. Each record ends in a checksum so one torn by a crash
+    // is skipped on resume, leaving the last complete state. Once the appended
+    // records outgrow a full snapshot, a snapshot replaces the file via rename().
+    struct CheckpointHeader
+    {
+        char     magic[8]; // CHECKPOINT_MAGIC
+        int32_t  width, height, scale, depth;
+        int32_t  source  ; // SEED_GRID, SEED_RANDOM, SEED_SOBOL or SEED_ADAPTIVE
+        int32_t  symmetry;
+        int32_t  layout  ; // gnLayoutShift: the counts are saved in memory order
+        int32_t  adaptive; // gnAdaptiveStride
+        int32_t  period  ; // gnPeriodExponent, 0 = off
+        int32_t  pad     ;
+        uint64_t key, samples;
+        double   world [4];
+        double   domain[4];
+        uint64_t work    ; // work items, in the order they were built
+    };
+
+    struct CheckpointRecord // then the done bitmap, the blocks and a checksum
+    {
+        char     magic[8]; // CHECKPOINT_RECORD
+        uint64_t blocks  ; // each is its index then its counts
+        uint64_t bytes   ; // whole record, checksum included
+    };
+
+    const char    CHECKPOINT_MAGIC [8] = { 'B','U','D','D','C','K','P','1' };
+    const char    CHECKPOINT_RECORD[8] = { 'B','U','D','D','R','E','C','1' };
+    const int     CHECKPOINT_BLOCK_SHIFT = 12;   // 4096 counts = 32 KB per block
+    const double  CHECKPOINT_SLACK       = 0.05; // of the interval: an epoch ending this early still checkpoints
+
+    const char   *gpFileNameCheckpoint = 0;    // -checkpoint#
+    const char   *gpFileNameResume     = 0;    // --resume
+    double        gnCheckpointMinutes  = 10.;
+    uint64_t      gnCheckpointItems    =   0;  // work items the bitmap covers
+    uint8_t      *gaCheckpointDone     = NULL; // [ item / 8 ] bit set once the work item is finished
+    uint8_t      *gaCheckpointDirty    = NULL; // [ block ] counts changed since the last checkpoint
+    uint64_t      gnCheckpointBytes    =   0;  // valid length of the file; 0 = no snapshot yet
+    int           gnCheckpoints        =   0;
+    double        gnCheckpointSeconds  =  0.;
+
+    // Per-thread counters; summed after the scatter
+    struct alignas(64) ThreadStats // own cache lines: written from the seed loop
+    {
+        uint64_t nEscaped    ; // seeds that escaped and were plotted
+        uint64_t nOrbitCached; // ... of which were deposited from the orbit cache
+        uint64_t nCulled     ; // seeds skipped by the interior test
+        uint64_t nPeriodic   ; // seeds stopped early by periodicity checking
+
+        // SEED_METROPOLIS
+        uint64_t nSamples    ; // seeds iterated
+        uint64_t nProposed   ; // mutations tried
+        uint64_t nAccepted   ; // ... of which were accepted
+        uint64_t nUniform    ; // uniform seeds iterated: chain starts and large mutations
+        uint64_t nUniformHits; // ... sum of their contributions, an estimate of E[f]
+        uint64_t nVisits     ; // samples spent on a state that contributes, each deposits a total weight of 1
+        uint64_t nVisitHits  ; // ... sum of the contribution of the chain's state, per sample
+    };
+    ThreadStats gaThreadsStats[ MAX_THREADS ];
+
+    // Seed loop schedule. The cost of a seed ranges from 2 iterations outside
+    // the set to the max depth on its boundary, so equal shares of the seeds
+    // aren't equal shares of the work. Threads take ranges of seeds from a
+    // shared cursor instead; a range may span several work items.
+    enum Schedule_e
+    {
+         SCHEDULE_COST = 0 // each thread sizes its next range from the cost per seed of its last one
+        ,SCHEDULE_GUIDED   // remaining seeds / threads, as OpenMP guided
+        ,SCHEDULE_STATIC   // one equal share per thread, as OpenMP static
+        ,NUM_SCHEDULE
+    };
+
+    const char *gaScheduleName[ NUM_SCHEDULE ] =
+    {
+         "cost"
+        ,"guided"
+        ,"static"
+    };
+
+    struct alignas(64) ThreadSchedule // own cache line: written after every range
+    {
+        double   nBusy  ; // seconds spent iterating
+        double   nEnd   ; // when the thread ran out of seeds
+        double   nCost  ; // seconds per seed of the last range
+        size_t   nRange ; // seeds in the last range
+        int      nRanges;
+        int      nEpoch ; // static: last epoch the thread took its share of
+    };
+
+    const double        SCHEDULE_SECONDS = 0.005; // target time per range
+    const size_t        SCHEDULE_MIN     =    64; // seeds per range, a few SIMD batches
+    int                 gnSchedule       = SCHEDULE_COST;
+    ThreadSchedule      gaThreadsSchedule[ MAX_THREADS ];
+    alignas(64) std::atomic<size_t> gnScheduleNext( 0 ); // first seed not handed out yet
+    int                 gnScheduleEpoch  =     0; // scatter epochs so far, see -checkpoint
+
+    // [ range ] start and end time of each range a thread ran, for the busy time in the tail
+    double             *gaThreadsRanges   [ MAX_THREADS ];
+    size_t              gnThreadsRangesMax[ MAX_THREADS ];
+
+    // Longest job first: grid rows are handed out most expensive first, so the
+    // few rows through the set boundary start early and cheap rows fill the
+    // gaps at the end instead of an expensive row starting last. A row costs
+    // what its band of gnScale rows (one image row) is predicted to: a quick
+    // escape pass over COST_SAMPLES seeds of the band, or the time the last
+    // run with the same -costmap file measured.
+    enum Order_e
+    {
+         ORDER_LJF = 0 // most expensive band first
+        ,ORDER_ROWS    // grid order
+        ,NUM_ORDER
+    };
+
+    const char *gaOrderName[ NUM_ORDER ] =
+    {
+         "ljf"
+        ,"rows"
+    };
+
+    struct CostMapHeader
+    {
+        char     magic[8]; // COSTMAP_MAGIC
+        int32_t  width, height, scale, depth;
+        int32_t  symmetry; // mirrored rows aren't measured
+        int32_t  bands   ; // doubles that follow, seconds per band
+        double   world [4];
+        double   domain[4];
+    };
+
+    const char    COSTMAP_MAGIC[8]   = { 'B','U','D','D','C','S','T','1' };
+    const int     COST_SAMPLES       =   64; // seeds per band in the escape pass
+
+    int           gnOrder            = ORDER_LJF;
+    const char   *gpFileNameCostMap  = 0;    // -costmap: order by the cost measured last time, save this run's
+    double       *gaCostBand         = NULL; // [ band ] predicted cost, only the ratios matter
+    double       *gaCostMeasured     = NULL; // [ band ] seconds spent iterating the band's seeds
+    int           gnCostBands        =    0;
+
 
 // Timer___________________________________________________________________________ 
 
@@ -215,171 +645,662 @@
 
 // Implementation _________________________________________________________________ 
 
+// @return Bytes of physical memory, 0 = unknown
 // ========================================================================
-void AllocImageMemory( const int width, const int height )
+uint64_t Memory_Physical()
 {
-    gnImageArea = width * height;
+#if defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+    const long nPages = sysconf( _SC_PHYS_PAGES );
+    const long nBytes = sysconf( _SC_PAGESIZE   );
+    if( (nPages > 0) && (nBytes > 0) )
+        return (uint64_t) nPages * (uint64_t) nBytes;
+#endif
+    return 0;
+}
 
-    const size_t nGreyscaleBytes = gnImageArea  * sizeof( uint16_t );
-    gpGreyscaleTexels = (uint16_t*) malloc( nGreyscaleBytes );          // 1x 16-bit channel: W
-    memset( gpGreyscaleTexels, 0, nGreyscaleBytes );
 
-    const size_t chromaticBytes  = gnImageArea * 3 * sizeof( uint8_t ); // 3x 8-bit channels: R,G,B
-    gpChromaticTexels = (uint8_t*) malloc( chromaticBytes );
-    memset( gpChromaticTexels, 0, chromaticBytes );
+// Zeroed memory for an image-sized buffer. Pages are only backed (and zeroed)
+// by the OS when first written, by whichever thread writes them.
+// ========================================================================
+void* Image_Alloc( const size_t nBytes )
+{
+#if defined(MAP_ANONYMOUS)
+    const size_t HUGE_PAGE = 2 << 20;
+    const size_t nSize     = (gnHugePages != HUGE_OFF) ? (nBytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1) : nBytes;
 
-    for( int i = 0; i < (BUFFER_BACKSPACE-1); i++ )
-        gaBackspace[ i ] = 8; // ASCII backspace
+    #if defined(MAP_HUGETLB)
+    if( gnHugePages == HUGE_TLB )
+    {
+        void *pTLB = mmap( NULL, nSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+        if( pTLB != MAP_FAILED )
+            return pTLB;
 
-    gaBackspace[ BUFFER_BACKSPACE-1 ] = 0;
+        printf( "WARNING: Not enough reserved huge pages for %u MB, using transparent huge pages\n", (unsigned)(nSize >> 20) );
+        gnHugePages = HUGE_THP;
+    }
+    #endif
 
-// BEGIN OMP
-    if(!gnThreadsActive) // user didn't specify how many threads to use, default to all of them
-        gnThreadsActive = gnThreadsMaximum;
-    else
-        omp_set_num_threads( gnThreadsActive );
+    void *p = mmap( NULL, nSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if( p == MAP_FAILED )
+        return NULL;
 
-    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
-    {
-                gaThreadsTexels[ iThread ] = (uint16_t*) malloc( nGreyscaleBytes );
-        memset( gaThreadsTexels[ iThread ], 0,                   nGreyscaleBytes );
-    }
-// END OMP
+    #if defined(MADV_HUGEPAGE)
+    if( gnHugePages != HUGE_OFF )
+        madvise( p, nSize, MADV_HUGEPAGE );
+    #endif
+
+    return p;
+#else
+    return calloc( nBytes, 1 );
+#endif
 }
 
 
 // ========================================================================
-void BMP_WriteColor24bit( const char * filename, const uint8_t *texelsRGB, const int width, const int height )
+void Image_Free( void *p, const size_t nBytes )
 {
-    uint32_t headers[13]; // 54 bytes == 13 x int32
-    FILE   * pFileSave;
-    int x, y, i;
+    if( !p )
+        return;
+#if defined(MAP_ANONYMOUS)
+    const size_t HUGE_PAGE = 2 << 20;
+    munmap( p, (gnHugePages != HUGE_OFF) ? (nBytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1) : nBytes );
+#else
+    (void) nBytes;
+    free( p );
+#endif
+}
 
-    // Stupid Windows BMP must have each scanline width padded to 4 bytes
-    int      nExtraBytes = (width * 3) % 4;
-    int      nPaddedSize = (width * 3 + nExtraBytes) * height;
-    uint32_t nPlanes     =  1      ; // 1 plane
-    uint32_t nBitcount   = 24 << 16; // 24-bit RGB; 32-bit packed for writing
 
-    // Header: Note that the "BM" identifier in bytes 0 and 1 is NOT included in these "headers".
-    headers[ 0] = nPaddedSize + 54;    // bfSize (total file size)
-    headers[ 1] = 0;                   // bfReserved1 bfReserved2
-    headers[ 2] = 54;                  // bfOffbits
-    headers[ 3] = 40;                  // biSize BITMAPHEADER
-    headers[ 4] = width;               // biWidth
-    headers[ 5] = height;              // biHeight
-    headers[ 6] = nBitcount | nPlanes; // biPlanes, biBitcount
-    headers[ 7] = 0;                   // biCompression
-    headers[ 8] = nPaddedSize;         // biSizeImage
-    headers[ 9] = 0;                   // biXPelsPerMeter
-    headers[10] = 0;                   // biYPelsPerMeter
-    headers[11] = 0;                   // biClrUsed
-    headers[12] = 0;                   // biClrImportant
+// @return index of texel <u,v> in the -tiled# layout
+// ========================================================================
+inline int Layout_Index( const int u, const int v, const int width, const int height )
+{
+    if( !gnLayoutShift )
+        return (v * width) + u;
 
-    pFileSave = fopen(filename, "wb");
-    if( pFileSave )
-    {
-        // Output Headers
-        fprintf(pFileSave, "BM");
-        for( i = 0; i < 13; i++ )
-        {
-           fprintf( pFileSave, "%c", ((headers[i]) >>  0) & 0xFF );
-           fprintf( pFileSave, "%c", ((headers[i]) >>  8) & 0xFF );
-           fprintf( pFileSave, "%c", ((headers[i]) >> 16) & 0xFF );
-           fprintf( pFileSave, "%c", ((headers[i]) >> 24) & 0xFF );
-        }
+    const int size = 1 << gnLayoutShift;
+    const int mask = size - 1;
+    const int u0   = u & ~mask; // tile origin
+    const int v0   = v & ~mask;
+    const int nU   = (width  - u0 < size) ? width  - u0 : size; // tile size
+    const int nV   = (height - v0 < size) ? height - v0 : size;
 
-        // Stupid Windows BMP are written upside down
-        for( y = height - 1; y >= 0; y-- )
-        {
-            const uint8_t* scanline = &texelsRGB[ y*width*3 ];
-            for( x = 0; x < width; x++ )
-            {
-                // swizzle rgb -> brg
-                uint8_t r = *scanline++;
-                uint8_t g = *scanline++;
-                uint8_t b = *scanline++;
+    return (v0 * width) + (u0 * nV) + ((v & mask) * nU) + (u & mask);
+}
 
-                // Stupid Windows BMP are written BGR
-                fprintf( pFileSave, "%c", b );
-                fprintf( pFileSave, "%c", g );
-                fprintf( pFileSave, "%c", r );
-           }
 
-           if( nExtraBytes ) // See above - BMP lines must be of lengths divisible by 4 bytes.
-              for( i = 0; i < nExtraBytes; i++ )
-                 fprintf( pFileSave, "%c", 0 );
+// Convert the counts between row-major and the -tiled# layout
+// ========================================================================
+void Layout_Convert( const bool bToRowMajor )
+{
+    if( !gnLayoutShift )
+        return;
+
+    uint64_t *pDst = (uint64_t*) Image_Alloc( gnImageArea * sizeof( uint64_t ) );
+
+// BEGIN OMP
+#pragma omp parallel for schedule(static)
+// END OMP
+    for( int v = 0; v < gnHeight; v++ )
+        for( int u = 0; u < gnWidth; u++ )
+        {
+            const int iRow   = (v * gnWidth) + u;
+            const int iTiled = Layout_Index( u, v, gnWidth, gnHeight );
+
+            if( bToRowMajor )
+                pDst[ iRow   ] = gpCountTexels[ iTiled ];
+            else
+                pDst[ iTiled ] = gpCountTexels[ iRow   ];
         }
 
-        fclose( pFileSave );
-    }
+    Image_Free( gpCountTexels, gnImageArea * sizeof( uint64_t ) );
+    gpCountTexels = pDst;
 }
 
 
-// Scan all pixels and return the maximum brightness
+// Periodicity: Zn came within tolerance of a previous Zm, is it really a cycle?
+// An exact match means the iteration itself is periodic and can never escape.
+// A near match only proves something if the orbit is trapped: we estimate the
+// multiplier of the cycle through Zm, pick a disc around Zm that f^p should
+// map into itself, and check that with ball arithmetic. If f^p maps the disc
+// into itself then every Zm+kp stays inside it and the seed can never escape.
+// An orbit that merely passes near a cycle on its way out fails the check.
 // ========================================================================
-uint16_t
-Image_Greyscale16bitMaxValue( const uint16_t *texels, const int width, const int height )
+bool Periodic_Confirm( const double pr, const double pi, const double x, const double y, const double r, const double i, const int period )
 {
-    const uint16_t *pSrc = texels;
-    const int       nLen = width * height;
-    /* */ int       nMax = *pSrc;
+    if( (r == pr) && (i == pi) )
+        return true;
 
-    for( int iPix = 0; iPix < nLen; iPix++ )
+    double zr = pr, zi = pi, s, j;
+    double nMultiplier2 = 1.0; // |d Zn+p / d Zn|^2
+
+    for( int depth = 0; depth < period; depth++ )
     {
-        if( nMax < *pSrc )
-            nMax = *pSrc;
-        pSrc++;
+        nMultiplier2 *= 4.0 * (zr*zr + zi*zi);
+
+        s = (zr*zr - zi*zi) + x;
+        j = (2.0*zr*zi)     + y;
+
+        zr = s;
+        zi = j;
     }
 
-    return nMax;
+    if( !(nMultiplier2 < 1.0) )
+        return false;
+
+    // Disc of radius rho around Zm; f( center, radius ) is inside ( center^2 + C, 2|center|*radius + radius^2 )
+    const double rho = 2.0 * sqrt( (r - pr)*(r - pr) + (i - pi)*(i - pi) ) / (1.0 - sqrt( nMultiplier2 ));
+    double       rad = rho;
+
+    zr = pr;
+    zi = pi;
+
+    for( int depth = 0; depth < period; depth++ )
+    {
+        rad = 2.0 * sqrt( zr*zr + zi*zi ) * rad + rad*rad;
+
+        s = (zr*zr - zi*zi) + x;
+        j = (2.0*zr*zi)     + y;
+
+        zr = s;
+        zi = j;
+    }
+
+    return (sqrt( (zr - pr)*(zr - pr) + (zi - pi)*(zi - pi) ) + rad) < rho;
 }
 
 
+// Brent's cycle detection: compare each Zn against a saved Zm and move Zm up
+// to Zn every time the window doubles, so any period eventually fits inside it.
 // ========================================================================
-void
-Image_Greyscale16bitRotateRight( const uint16_t *input, const int width, const int height, uint16_t *output_ )
+struct Periodicity
 {
-    // Source row[y] -> Dest col[ h-y-1 ]
-    //   Source   ->
-    //   0 1 2 4     5 0
-    //   5 6 7 8     6 1
-    //               7 2
-    //               8 4
+    double pr, pi; // saved Zm
+    int    nSince; // steps since Zm
+    int    nWindow;
 
-    // Linearized 1D memory Layout for Source and Dest
-    // [    0*w] [1] [2] .. [1w-1]
-    // [    1*w] ...........[2w-1]
-    // [    2*w] ...........[3w-1]
-    // :                         :
-    // [(h-1)*w] .........  [hw-1]
+    inline void Reset()
+    {
+        pr      = 0.;
+        pi      = 0.;
+        nSince  = 0;
+        nWindow = 1;
+    }
 
-    for( int y = 0; y < height; y++ )
+    // @return true if the orbit is periodic and will never escape
+    inline bool Cycle( const double r, const double i, const double x, const double y )
     {
-        const uint16_t *pSrc = input   + ((width   ) * y);
-        /* */ uint16_t *pDst = output_ + ((height-1) - y);
+        const double dr = r - pr;
+        const double di = i - pi;
 
-        for( int x = 0; x < width; x++ )
+        nSince++;
+
+        if( (dr*dr + di*di) <= gnPeriodTolerance2 )
         {
-            *pDst = *pSrc;
+            if( Periodic_Confirm( pr, pi, x, y, r, i, nSince ) )
+                return true;
+
+            // Not trapped (yet); restart the window from here so we don't re-check every step
+            pr     = r;
+            pi     = i;
+            nSince = 0;
+            return false;
+        }
 
-             pSrc++;
-             pDst += height;
+        if( nSince == nWindow )
+        {
+            pr       = r;
+            pi       = i;
+            nSince   = 0;
+            nWindow *= 2;
         }
+
+        return false;
     }
+};
+
+
+// @return bytes reserved per thread for its tiles
+// ========================================================================
+size_t Sparse_PoolBytes()
+{
+    return (size_t)(gnBinTiles / 4 + 1) << (2 * gnBinTileShift + 1);
 }
 
 
+// Orbit points of an n x n grid of seeds over the seed domain, per tile
+// @return total points in the view
 // ========================================================================
-uint16_t
-Image_Greyscale16bitToBrightnessBias( int* bias_, float* scaleR_, float* scaleG_, float* scaleB_ )
+uint64_t Sparse_Probe( const int n, uint32_t *aHits )
 {
-    uint16_t nMaxBrightness = Image_Greyscale16bitMaxValue( gpGreyscaleTexels, gnWidth, gnHeight );
+    const double sx = (double)(gnWidth  - 1.) / (gnWorldMaxX - gnWorldMinX);
+    const double sy = (double)(gnHeight - 1.) / (gnWorldMaxY - gnWorldMinY);
+    const double dx = (gnDomainMaxX - gnDomainMinX) / n;
+    const double dy = (gnDomainMaxY - gnDomainMinY) / n;
+    /* */ uint64_t nTotal = 0;
 
-    if( gbAutoBrightness )
-    {
-        if( nMaxBrightness < 256)
-            *bias_ = 0;
+    memset( aHits, 0, gnBinTiles * sizeof( uint32_t ) );
+
+// BEGIN OMP
+#pragma omp parallel for schedule(dynamic,64) reduction(+:nTotal)
+// END OMP
+    for( int iSeed = 0; iSeed < n * n; iSeed++ )
+    {
+        const double x = gnDomainMinX + ((iSeed % n) + 0.5) * dx;
+        const double y = gnDomainMinY + ((iSeed / n) + 0.5) * dy;
+
+        if( gbCullInterior && Interior( x, y ) )
+            continue;
+
+        Periodicity cycle;
+        cycle.Reset();
+
+        double r = 0., i = 0., s, j;
+        int    depth = 0;
+        for( ; (depth < gnMaxDepth) && ((r*r + i*i) <= 4.0); depth++ )
+        {
+            s = (r*r - i*i) + x;
+            j = (2.0*r*i)   + y;
+            r = s;
+            i = j;
+
+            if( gbPeriodic && cycle.Cycle( r, i, x, y ) )
+                break;
+        }
+
+        if( (r*r + i*i) <= 4.0 ) // never escaped, never plotted
+            continue;
+
+        r = 0.; i = 0.;
+        for( int iStep = 0; iStep < depth; iStep++ )
+        {
+            s = (r*r - i*i) + x;
+            j = (2.0*r*i)   + y;
+            r = s;
+            i = j;
+
+            const int u = (int) ((r - gnWorldMinX) * sx);
+            const int v = (int) ((i - gnWorldMinY) * sy);
+            if( (u < gnWidth) && (v < gnHeight) && (u >= 0) && (v >= 0) )
+            {
+// BEGIN OMP
+#pragma omp atomic
+// END OMP
+                aHits[ ((v >> gnBinTileShift) * gnBinTilesX) + (u >> gnBinTileShift) ]++;
+                nTotal++;
+            }
+        }
+    }
+
+    return nTotal;
+}
+
+
+// Estimate the fraction of the tiles one thread will touch. The probe grid is
+// refined until it has SPARSE_PROBE_HITS points per tile or reaches 1% of the
+// seeds; each tile's hits are then a Poisson process over the thread's share of
+// the seeds. A probe that ran out of budget first has seen too few points to
+// place them, so it assumes they spread evenly, which touches the most tiles.
+// ========================================================================
+double Sparse_ProbeDensity( int *nProbe_ )
+{
+    const double nSeeds = gnSamples ? (double) gnSamples : (double) gnWidth * gnScale * gnHeight * gnScale;
+    /* */ uint32_t *aHits = (uint32_t*) malloc( gnBinTiles * sizeof( uint32_t ) );
+    /* */ uint64_t  nHits = 0;
+    /* */ int       n     = (int) sqrt( nSeeds / 100. ); // first grid stays inside the 1% too
+
+    if( n > SPARSE_PROBE )
+        n = SPARSE_PROBE;
+    if( n < 1 )
+        n = 1;
+
+    for( ;; n *= 2 )
+    {
+        nHits = Sparse_Probe( n, aHits );
+        if( (nHits >= (uint64_t) SPARSE_PROBE_HITS * gnBinTiles) || (4. * n * n > nSeeds / 100.) )
+            break;
+    }
+    *nProbe_ = n;
+
+    const double nShare   = nSeeds / (gnThreadsActive * (double) n * n); // thread's seeds per probe seed
+    /* */ double nTouched = 0.;
+
+    if( nHits >= (uint64_t) SPARSE_PROBE_HITS * gnBinTiles )
+        for( int iTile = 0; iTile < gnBinTiles; iTile++ )
+            nTouched += 1. - exp( -(double) aHits[ iTile ] * nShare );
+    else
+        nTouched = gnBinTiles * (1. - exp( -(double) nHits * nShare / gnBinTiles ));
+
+    free( aHits );
+    return nTouched / gnBinTiles;
+}
+
+
+// ========================================================================
+void AllocImageMemory( const int width, const int height )
+{
+    gnImageArea = width * height;
+
+    const size_t nGreyscaleBytes = gnImageArea  * sizeof( uint16_t );
+    gpGreyscaleTexels = (uint16_t*) Image_Alloc( nGreyscaleBytes );                    // 1x 16-bit channel: W
+    gpCountTexels     = (uint64_t*) Image_Alloc( gnImageArea * sizeof( uint64_t ) );   // touched below
+
+    const size_t chromaticBytes  = gnImageArea * 3 * sizeof( uint8_t ); // 3x 8-bit channels: R,G,B
+    if( gbSaveBMP )
+        gpChromaticTexels = (uint8_t*) Image_Alloc( chromaticBytes );
+
+// BEGIN OMP
+    if(!gnThreadsActive) // user didn't specify how many threads to use, default to all of them
+        gnThreadsActive = gnThreadsMaximum;
+    else
+        omp_set_num_threads( gnThreadsActive );
+
+    // Tile # must fit in 16 bits
+    while( (((gnWidth  - 1) >> gnBinTileShift) + 1) * (((gnHeight - 1) >> gnBinTileShift) + 1) > 65536 )
+        gnBinTileShift++;
+
+    gnBinTilesX = ((gnWidth  - 1) >> gnBinTileShift) + 1;
+    gnBinTiles  = ((gnHeight - 1) >> gnBinTileShift) * gnBinTilesX + gnBinTilesX;
+
+    if( gnAccumulate == ACCUMULATE_AUTO )
+    {
+        // Per-thread copies are fastest but scale with -j; when they would take
+        // more than half the RAM fall back to the single shared image
+        const uint64_t nCopies = (uint64_t) gnThreadsActive * nGreyscaleBytes;
+        const uint64_t nMemory = Memory_Physical();
+
+        gnAccumulate = (nMemory && (nCopies > nMemory / 2)) ? ACCUMULATE_ATOMIC : ACCUMULATE_COPIES;
+
+        if( gnAccumulate == ACCUMULATE_ATOMIC )
+            printf( "Accumulate: %d x %u MB copies won't fit in %u MB RAM, using atomic\n"
+                , gnThreadsActive, (unsigned)(nGreyscaleBytes >> 20), (unsigned)(nMemory >> 20) );
+
+        // When each thread's orbits only hit a few of the tiles, sparse tiles save
+        // most of the copies and their gather. Not when the copies don't fit: a
+        // thread that turned out dense would allocate its full copy after all.
+        // A domain no bigger than the view sends most orbits back across it, so
+        // the probe only runs for a wider one. -extend keeps what its first run used.
+        const double nDomainArea = (gnDomainMaxX - gnDomainMinX) * (gnDomainMaxY - gnDomainMinY);
+        const double nViewArea   = (gnWorldMaxX  - gnWorldMinX ) * (gnWorldMaxY  - gnWorldMinY );
+
+        if( (gnAccumulate == ACCUMULATE_COPIES) && (gnSeedSource != SEED_METROPOLIS) && (gnSeedSource != SEED_RESUME) && (nDomainArea > nViewArea) )
+        {
+            // Half the quarter that makes a thread densify: the probe sees few of
+            // the rare long orbits that reach a zoomed view, so it reads low
+            int          nProbe   = 0;
+            const double nDensity = Sparse_ProbeDensity( &nProbe );
+            if( 8 * nDensity < 1. )
+            {
+                gnAccumulate = ACCUMULATE_SPARSE;
+                printf( "Accumulate: %dx%d seed probe estimates %.1f%% of the tiles touched per thread, using sparse tiles\n", nProbe, nProbe, 100. * nDensity );
+            }
+        }
+    }
+
+    if( (gnAccumulate == ACCUMULATE_SPARSE) && gnLayoutShift )
+    {
+        printf( "WARNING: -tiled# isn't used by sparse tiles, they are already tiled\n" );
+        gnLayoutShift = 0;
+    }
+
+    if( (gnAccumulate == ACCUMULATE_SPARSE) && gbBinning )
+    {
+        printf( "WARNING: -bin# isn't used by sparse tiles, they are already applied a tile at a time\n" );
+        gbBinning = false;
+    }
+
+    // Shared policies deposit straight into the 64-bit counts
+    for( int iThread = 0; iThread < gnThreadsActive && (gnAccumulate == ACCUMULATE_COPIES); iThread++ )
+        gaThreadsTexels[ iThread ] = (uint16_t*) Image_Alloc( nGreyscaleBytes );
+
+    for( int iThread = 0; iThread < gnThreadsActive && (gnAccumulate == ACCUMULATE_BYTES); iThread++ )
+    {
+        Bytes &bytes = gaThreadsBytes[ iThread ];
+        bytes.texels = (uint8_t *) Image_Alloc( gnImageArea );
+        bytes.aLog   = (uint64_t*) malloc( BYTES_LOG * sizeof( uint64_t ) );
+        bytes.nLog   = 0;
+        bytes.nSpill = 0;
+    }
+
+    for( int iThread = 0; iThread < gnThreadsActive && (gnSeedSource == SEED_METROPOLIS); iThread++ )
+        gaThreadsWeights[ iThread ] = (double*) Image_Alloc( gnImageArea * sizeof( double ) );
+
+    // Each thread pins itself. Its buffers are first written by its own deposits,
+    // so their pages are on its node, and pages it never deposits into are never backed.
+    Numa_Init();
+
+#pragma omp parallel num_threads( gnThreadsActive )
+    {
+        const int iTid = omp_get_thread_num();
+
+        if( gnPin != PIN_NONE )
+            Numa_Pin( iTid, gnThreadsActive, gnPin );
+
+        gaThreadsNode[ iTid ] = Numa_CurrentNode();
+    }
+
+    // Unlike the copies, touch the counts up front: the gather's first read of
+    // an untouched page maps the zero page, then its write faults a second time.
+    // Same row bands as the gather so each lands on the node that will add into it.
+#pragma omp parallel for schedule(static)
+    for( int iRow = 0; iRow < height; iRow++ )
+        memset( gpCountTexels + (size_t)iRow * width, 0, width * sizeof( uint64_t ) );
+// END OMP
+
+    if( gbOrbitCache )
+    {
+        const size_t nBudget = (size_t)gnOrbitBudgetMB << 20;
+
+        // Scalar: 1 orbit of re, im
+        gnOrbitCapacity = (int)(nBudget / (2 * sizeof( double )));
+        if( gnOrbitCapacity > gnMaxDepth )
+            gnOrbitCapacity = gnMaxDepth;
+
+        // SIMD: ring of [ row ][ 8 lanes ] re, im
+        const size_t nRowBytes = 2 * 8 * sizeof( double );
+        gnOrbitRing = 1;
+        while( (gnOrbitRing < (size_t)gnMaxDepth) && (2*gnOrbitRing*nRowBytes <= nBudget) )
+            gnOrbitRing *= 2;
+
+        size_t nOrbitBytes = gnOrbitRing * nRowBytes;
+        if( nOrbitBytes < gnOrbitCapacity * 2 * sizeof( double ) )
+            nOrbitBytes = gnOrbitCapacity * 2 * sizeof( double );
+
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+            gaThreadsOrbit[ iThread ] = (double*) malloc( nOrbitBytes );
+    }
+
+    if( gnAccumulate == ACCUMULATE_ATOMIC )
+    {
+        if( gnAtomicStripes > gnThreadsActive )
+            gnAtomicStripes = gnThreadsActive;
+
+        gaAtomicStripes[ 0 ] = gpCountTexels;
+        for( int iStripe = 1; iStripe < gnAtomicStripes; iStripe++ )
+            gaAtomicStripes[ iStripe ] = (uint64_t*) Image_Alloc( gnImageArea * sizeof( uint64_t ) );
+    }
+
+    for( int iThread = 0; iThread < gnThreadsActive && (gnAccumulate == ACCUMULATE_SPARSE); iThread++ )
+    {
+        Sparse &sparse = gaThreadsSparse[ iThread ];
+        sparse.aTile    = (uint16_t**) calloc( gnBinTiles, sizeof( uint16_t* ) );
+        sparse.pool     = (uint16_t *) Image_Alloc( Sparse_PoolBytes() );
+        sparse.nTouched = 0;
+        sparse.texels   = NULL;
+    }
+
+    if( gbBinning )
+    {
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+        {
+            Staging &staging = gaThreadsStaging[ iThread ];
+            staging.aEntry  = (uint64_t*) malloc( gnBinEntries * sizeof( uint64_t ) );
+            staging.aSorted = (gnAccumulate == ACCUMULATE_OWNER) ? NULL : (uint64_t*) malloc( gnBinEntries * sizeof( uint64_t ) ); // -own sorts into a batch
+            staging.aStart  = (uint32_t*) malloc( (gnBinTiles + 1) * sizeof( uint32_t ) );
+            staging.aOwner  = (uint32_t*) malloc( (gnThreadsActive + 1) * sizeof( uint32_t ) );
+            staging.nEntry  = 0;
+            staging.texels  = gaThreadsTexels[ iThread ];
+            staging.stripe  = gaAtomicStripes[ iThread % gnAtomicStripes ];
+            staging.iThread = iThread;
+        }
+    }
+
+    if( gnAccumulate == ACCUMULATE_OWNER )
+    {
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+        {
+            Mailbox &mailbox = gaThreadsMailbox[ iThread ];
+            mailbox.pInbox = NULL;
+            mailbox.pFree  = NULL;
+            mailbox.pSpare = NULL;
+
+            for( int iBatch = 0; iBatch < OWNER_BATCHES; iBatch++ )
+            {
+                Batch *batch = new Batch;
+                batch->aEntry    = (uint64_t*) malloc( gnBinEntries    * sizeof( uint64_t ) );
+                batch->aParcel   = (Parcel  *) malloc( gnThreadsActive * sizeof( Parcel   ) );
+                batch->nParcels  = 0;
+                batch->iProducer = iThread;
+                batch->pNext     = mailbox.pSpare;
+                mailbox.pSpare   = batch;
+            }
+        }
+    }
+}
+
+
+// ========================================================================
+void BMP_WriteColor24bit( const char * filename, const uint8_t *texelsRGB, const int width, const int height )
+{
+    uint32_t headers[13]; // 54 bytes == 13 x int32
+    FILE   * pFileSave;
+    int x, y, i;
+
+    // Stupid Windows BMP must have each scanline width padded to 4 bytes
+    int      nExtraBytes = (width * 3) % 4;
+    int      nPaddedSize = (width * 3 + nExtraBytes) * height;
+    uint32_t nPlanes     =  1      ; // 1 plane
+    uint32_t nBitcount   = 24 << 16; // 24-bit RGB; 32-bit packed for writing
+
+    // Header: Note that the "BM" identifier in bytes 0 and 1 is NOT included in these "headers".
+    headers[ 0] = nPaddedSize + 54;    // bfSize (total file size)
+    headers[ 1] = 0;                   // bfReserved1 bfReserved2
+    headers[ 2] = 54;                  // bfOffbits
+    headers[ 3] = 40;                  // biSize BITMAPHEADER
+    headers[ 4] = width;               // biWidth
+    headers[ 5] = height;              // biHeight
+    headers[ 6] = nBitcount | nPlanes; // biPlanes, biBitcount
+    headers[ 7] = 0;                   // biCompression
+    headers[ 8] = nPaddedSize;         // biSizeImage
+    headers[ 9] = 0;                   // biXPelsPerMeter
+    headers[10] = 0;                   // biYPelsPerMeter
+    headers[11] = 0;                   // biClrUsed
+    headers[12] = 0;                   // biClrImportant
+
+    pFileSave = fopen(filename, "wb");
+    if( pFileSave )
+    {
+        // Output Headers
+        fprintf(pFileSave, "BM");
+        for( i = 0; i < 13; i++ )
+        {
+           fprintf( pFileSave, "%c", ((headers[i]) >>  0) & 0xFF );
+           fprintf( pFileSave, "%c", ((headers[i]) >>  8) & 0xFF );
+           fprintf( pFileSave, "%c", ((headers[i]) >> 16) & 0xFF );
+           fprintf( pFileSave, "%c", ((headers[i]) >> 24) & 0xFF );
+        }
+
+        // Stupid Windows BMP are written upside down
+        for( y = height - 1; y >= 0; y-- )
+        {
+            const uint8_t* scanline = &texelsRGB[ y*width*3 ];
+            for( x = 0; x < width; x++ )
+            {
+                // swizzle rgb -> brg
+                uint8_t r = *scanline++;
+                uint8_t g = *scanline++;
+                uint8_t b = *scanline++;
+
+                // Stupid Windows BMP are written BGR
+                fprintf( pFileSave, "%c", b );
+                fprintf( pFileSave, "%c", g );
+                fprintf( pFileSave, "%c", r );
+           }
+
+           if( nExtraBytes ) // See above - BMP lines must be of lengths divisible by 4 bytes.
+              for( i = 0; i < nExtraBytes; i++ )
+                 fprintf( pFileSave, "%c", 0 );
+        }
+
+        fclose( pFileSave );
+    }
+}
+
+
+// Scan all pixels and return the maximum brightness
+// ========================================================================
+uint16_t
+Image_Greyscale16bitMaxValue( const uint16_t *texels, const int width, const int height )
+{
+    const uint16_t *pSrc = texels;
+    const int       nLen = width * height;
+    /* */ int       nMax = *pSrc;
+
+    for( int iPix = 0; iPix < nLen; iPix++ )
+    {
+        if( nMax < *pSrc )
+            nMax = *pSrc;
+        pSrc++;
+    }
+
+    return nMax;
+}
+
+
+// ========================================================================
+void
+Image_Greyscale16bitRotateRight( const uint16_t *input, const int width, const int height, uint16_t *output_ )
+{
+    // Source row[y] -> Dest col[ h-y-1 ]
+    //   Source   ->
+    //   0 1 2 4     5 0
+    //   5 6 7 8     6 1
+    //               7 2
+    //               8 4
+
+    // Linearized 1D memory Layout for Source and Dest
+    // [    0*w] [1] [2] .. [1w-1]
+    // [    1*w] ...........[2w-1]
+    // [    2*w] ...........[3w-1]
+    // :                         :
+    // [(h-1)*w] .........  [hw-1]
+
+    for( int y = 0; y < height; y++ )
+    {
+        const uint16_t *pSrc = input   + ((width   ) * y);
+        /* */ uint16_t *pDst = output_ + ((height-1) - y);
+
+        for( int x = 0; x < width; x++ )
+        {
+            *pDst = *pSrc;
+
+             pSrc++;
+             pDst += height;
+        }
+    }
+}
+
+
+// ========================================================================
+uint16_t
+Image_Greyscale16bitToBrightnessBias( int* bias_, float* scaleR_, float* scaleG_, float* scaleB_ )
+{
+    uint16_t nMaxBrightness = Image_Greyscale16bitMaxValue( gpGreyscaleTexels, gnWidth, gnHeight );
+
+    if( gbAutoBrightness )
+    {
+        if( nMaxBrightness < 256)
+            *bias_ = 0;
 
         // TODO: if bright < 256 should this be adjusted?
         *bias_ = (int)(-0.045 * nMaxBrightness); // low-pass noise filter; if greyscale pixel < bias then greyscale pixel = 0
@@ -455,27 +1376,565 @@ char* itoaComma( size_t n, char *output_ = NULL )
 }
 
 
+// Read a 16, 32, or 64-bit raw; the texel size is implied by the file size
+// @return true if the file held exactly width * height texels
 // ========================================================================
-void
-RAW_WriteGreyscale16bit( const char *filename, const uint16_t *texels, const int width, const int height )
+bool
+RAW_ReadGreyscale( const char *filename, uint64_t *texels_, const int width, const int height )
 {
-    FILE *file = fopen( filename, "wb" );
-    if( file )
-    {
-        const size_t area = width * height;
-        fwrite( texels, sizeof( uint16_t ), area, file );
-        fclose( file );
-    }
-}
+    FILE *file = fopen( filename, "rb" );
+    if( !file )
+        return false;
 
+    fseek( file, 0, SEEK_END );
+    const long   nBytes = ftell( file );
+    fseek( file, 0, SEEK_SET );
 
-// @param wx World X start location
-// @param wy World Y start location
-// @param sx World to Image scale X
+    const size_t area   = width * height;
+    const size_t nSize  = area ? nBytes / area : 0; // bytes per texel
+    bool         bRead  = (nSize * area == (size_t)nBytes) && (nSize == 2 || nSize == 4 || nSize == 8);
+
+    if( bRead )
+    {
+        uint8_t *pBuffer = (uint8_t*) malloc( nBytes );
+        bRead = (fread( pBuffer, 1, nBytes, file ) == (size_t)nBytes);
+
+        for( size_t iPix = 0; iPix < area; iPix++ )
+        {
+            if( nSize == 2 ) texels_[ iPix ] = ((uint16_t*) pBuffer)[ iPix ];
+            if( nSize == 4 ) texels_[ iPix ] = ((uint32_t*) pBuffer)[ iPix ];
+            if( nSize == 8 ) texels_[ iPix ] = ((uint64_t*) pBuffer)[ iPix ];
+        }
+        free( pBuffer );
+    }
+
+    fclose( file );
+    return bRead;
+}
+
+
+// Write counts as 32-bit or 64-bit raw
+// ========================================================================
+void
+RAW_WriteGreyscaleWide( const char *filename, const uint64_t *texels, const int width, const int height, const int bits )
+{
+    FILE *file = fopen( filename, "wb" );
+    if( file )
+    {
+        const size_t area = width * height;
+        if( bits == 64 )
+            fwrite( texels, sizeof( uint64_t ), area, file );
+        else
+        {
+            uint32_t *pTexels = (uint32_t*) malloc( area * sizeof( uint32_t ) );
+            for( size_t iPix = 0; iPix < area; iPix++ )
+                pTexels[ iPix ] = (uint32_t) texels[ iPix ];
+            fwrite( pTexels, sizeof( uint32_t ), area, file );
+            free( pTexels );
+        }
+        fclose( file );
+    }
+}
+
+
+// ========================================================================
+void
+RAW_WriteGreyscale16bit( const char *filename, const uint16_t *texels, const int width, const int height )
+{
+    FILE *file = fopen( filename, "wb" );
+    if( file )
+    {
+        const size_t area = width * height;
+        fwrite( texels, sizeof( uint16_t ), area, file );
+        fclose( file );
+    }
+}
+
+
+// ========================================================================
+inline
+void Pending_Add( const int iTid, const uint64_t index, const double r, const double i, const int weight, const bool mirror )
+{
+    if( gnThreadsPending[ iTid ] == gnThreadsPendingMax[ iTid ] )
+    {
+        gnThreadsPendingMax[ iTid ] = gnThreadsPendingMax[ iTid ] ? 2*gnThreadsPendingMax[ iTid ] : 4096;
+        gaThreadsPending   [ iTid ] = (PendingSeed*) realloc( gaThreadsPending[ iTid ], gnThreadsPendingMax[ iTid ] * sizeof( PendingSeed ) );
+    }
+
+    PendingSeed &seed = gaThreadsPending[ iTid ][ gnThreadsPending[ iTid ]++ ];
+    memset( &seed, 0, sizeof( seed ) );
+    seed.index  = index;
+    seed.r      = r;
+    seed.i      = i;
+    seed.weight = (uint16_t) weight;
+    seed.mirror = mirror;
+}
+
+
+// ========================================================================
+int Pending_CompareIndex( const void *a, const void *b )
+{
+    const PendingSeed *pA = (const PendingSeed*) a;
+    const PendingSeed *pB = (const PendingSeed*) b;
+    return (pA->index > pB->index) - (pA->index < pB->index);
+}
+
+
+// Same weight and mirror next to each other so they can share work items
+// ========================================================================
+int Pending_CompareWork( const void *a, const void *b )
+{
+    const PendingSeed *pA = (const PendingSeed*) a;
+    const PendingSeed *pB = (const PendingSeed*) b;
+
+    if( pA->weight != pB->weight ) return (int)pA->weight - (int)pB->weight;
+    if( pA->mirror != pB->mirror ) return (int)pA->mirror - (int)pB->mirror;
+    return Pending_CompareIndex( a, b );
+}
+
+
+// Gather every thread's pending seeds, sorted by index so the file doesn't depend on -j
+// @return number of seeds saved, -1 on error
+// ========================================================================
+int64_t Pending_Save( const char *filename, const int source )
+{
+    size_t nTotal = 0;
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+        nTotal += gnThreadsPending[ iThread ];
+
+    PendingSeed *aSeeds = (PendingSeed*) malloc( (nTotal ? nTotal : 1) * sizeof( PendingSeed ) );
+    size_t       nSeeds = 0;
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+    {
+        memcpy( aSeeds + nSeeds, gaThreadsPending[ iThread ], gnThreadsPending[ iThread ] * sizeof( PendingSeed ) );
+        nSeeds += gnThreadsPending[ iThread ];
+    }
+    qsort( aSeeds, nSeeds, sizeof( PendingSeed ), Pending_CompareIndex );
+
+    PendingHeader header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.magic, PENDING_MAGIC, sizeof( header.magic ) );
+    header.width     = gnWidth;
+    header.height    = gnHeight;
+    header.scale     = gnScale;
+    header.depth     = gnMaxDepth;
+    header.source    = source;
+    header.symmetry  = gbSymmetry;
+    header.key       = gnRandomKey;
+    header.samples   = gnSamples;
+    header.world [0] = gnWorldMinX ; header.world [1] = gnWorldMaxX ; header.world [2] = gnWorldMinY ; header.world [3] = gnWorldMaxY ;
+    header.domain[0] = gnDomainMinX; header.domain[1] = gnDomainMaxX; header.domain[2] = gnDomainMinY; header.domain[3] = gnDomainMaxY;
+    header.count     = nSeeds;
+
+    int64_t nSaved = -1;
+    FILE   *file   = fopen( filename, "wb" );
+    if( file )
+    {
+        if( (fwrite( &header, sizeof( header ), 1, file ) == 1)
+        &&  (fwrite( aSeeds, sizeof( PendingSeed ), nSeeds, file ) == nSeeds) )
+            nSaved = nSeeds;
+        fclose( file );
+    }
+
+    free( aSeeds );
+    return nSaved;
+}
+
+
+// Restore the settings of the run that saved the seeds, then the seeds themselves
+// @return false if the file is missing or isn't a pending file
+// ========================================================================
+bool Pending_Load( const char *filename )
+{
+    FILE *file = fopen( filename, "rb" );
+    if( !file )
+        return false;
+
+    PendingHeader header;
+    if( (fread( &header, sizeof( header ), 1, file ) != 1)
+    ||  (memcmp( header.magic, PENDING_MAGIC, sizeof( header.magic ) ) != 0) )
+    {
+        fclose( file );
+        return false;
+    }
+
+    gnWidth         = header.width;
+    gnHeight        = header.height;
+    gnScale         = header.scale;
+    gnPendingDepth  = header.depth;
+    gnPendingSource = header.source;
+    gbSymmetry      = header.symmetry != 0;
+    gnRandomKey     = header.key;
+    gnSamples       = header.samples;
+    gnWorldMinX     = header.world [0]; gnWorldMaxX  = header.world [1]; gnWorldMinY  = header.world [2]; gnWorldMaxY  = header.world [3];
+    gnDomainMinX    = header.domain[0]; gnDomainMaxX = header.domain[1]; gnDomainMinY = header.domain[2]; gnDomainMaxY = header.domain[3];
+    gbDomain        = true;
+
+    gnPending = header.count;
+    gaPending = (PendingSeed*) malloc( (gnPending ? gnPending : 1) * sizeof( PendingSeed ) );
+    const bool bRead = fread( gaPending, sizeof( PendingSeed ), gnPending, file ) == gnPending;
+    fclose( file );
+
+    qsort( gaPending, gnPending, sizeof( PendingSeed ), Pending_CompareWork );
+    return bRead;
+}
+
+
+// Per-thread counters stay 16-bit to keep their cache footprint; a counter
+// that would wrap is spilled into the shared 64-bit counts and restarts at 0.
+// ========================================================================
+inline
+void deposit_texel( uint16_t *texels, const int iTexel, const int weight )
+{
+    const int sum = texels[ iTexel ] + weight;
+    if( sum <= 0xFFFF )
+    {
+        texels[ iTexel ] = (uint16_t) sum;
+        return;
+    }
+
+// BEGIN OMP
+#pragma omp atomic
+// END OMP
+    gpCountTexels[ iTexel ] += sum;
+    texels[ iTexel ] = 0;
+
+    if( gaCheckpointDirty )
+    {
+// BEGIN OMP
+#pragma omp atomic write
+// END OMP
+        gaCheckpointDirty[ iTexel >> CHECKPOINT_BLOCK_SHIFT ] = 1;
+    }
+}
+
+
+// Shared counts, see -atomic
+// ========================================================================
+inline
+void deposit_atomic( uint64_t *counts, const int iTexel, const int weight )
+{
+// BEGIN OMP
+#pragma omp atomic
+// END OMP
+    counts[ iTexel ] += weight;
+}
+
+
+// ========================================================================
+void Bytes_Flush( Bytes &bytes )
+{
+    for( int iLog = 0; iLog < bytes.nLog; iLog++ )
+        deposit_atomic( gpCountTexels, (uint32_t) bytes.aLog[ iLog ], (int)(bytes.aLog[ iLog ] >> 32) );
+
+    bytes.nLog = 0;
+}
+
+
+// ========================================================================
+inline
+void deposit_byte( Bytes &bytes, const int iTexel, const int weight )
+{
+    const int sum = bytes.texels[ iTexel ] + weight;
+    if( sum <= 0xFF )
+    {
+        bytes.texels[ iTexel ] = (uint8_t) sum;
+        return;
+    }
+
+    bytes.aLog[ bytes.nLog++ ] = (uint32_t) iTexel | ((uint64_t) sum << 32);
+    bytes.texels[ iTexel ] = 0;
+    bytes.nSpill++;
+
+    if( bytes.nLog == BYTES_LOG )
+        Bytes_Flush( bytes );
+}
+
+
+// Move a thread's tiles into a dense copy
+// ========================================================================
+void Sparse_Densify( Sparse &sparse )
+{
+    const int size = 1 << gnBinTileShift;
+
+    sparse.texels = (uint16_t*) Image_Alloc( gnImageArea * sizeof( uint16_t ) );
+
+    for( int iTile = 0; iTile < gnBinTiles; iTile++ )
+    {
+        uint16_t *tile = sparse.aTile[ iTile ];
+        if( !tile )
+            continue;
+
+        const int u0 = (iTile % gnBinTilesX) << gnBinTileShift;
+        const int v0 = (iTile / gnBinTilesX) << gnBinTileShift;
+        const int nU = (gnWidth  - u0 < size) ? gnWidth  - u0 : size;
+        const int nV = (gnHeight - v0 < size) ? gnHeight - v0 : size;
+
+        for( int v = 0; v < nV; v++ )
+            memcpy( sparse.texels + (size_t)(v0 + v) * gnWidth + u0, tile + (v << gnBinTileShift), nU * sizeof( uint16_t ) );
+
+        sparse.aTile[ iTile ] = NULL;
+    }
+
+    Image_Free( sparse.pool, Sparse_PoolBytes() );
+    sparse.pool = NULL;
+}
+
+
+// First deposit into a tile: allocate it from the depositing thread so its pages are local
+// @return NULL if the thread went dense instead
+// ========================================================================
+uint16_t* Sparse_Touch( Sparse &sparse, const int iTile )
+{
+    if( 4 * sparse.nTouched >= gnBinTiles )
+    {
+        Sparse_Densify( sparse );
+        return NULL;
+    }
+
+    uint16_t *tile = sparse.pool + ((size_t) sparse.nTouched << (2 * gnBinTileShift));
+    sparse.aTile[ iTile ] = tile;
+    sparse.nTouched++;
+    return tile;
+}
+
+
+// As deposit_texel() but into the thread's tile
+// ========================================================================
+inline
+void deposit_sparse( Sparse &sparse, const int u, const int v, const int iTexel, const int weight )
+{
+    const int iTile = ((v >> gnBinTileShift) * gnBinTilesX) + (u >> gnBinTileShift);
+    const int mask  = (1 << gnBinTileShift) - 1;
+
+    uint16_t *tile = sparse.aTile[ iTile ];
+    if( !tile && !(tile = Sparse_Touch( sparse, iTile )) )
+    {
+        deposit_texel( sparse.texels, iTexel, weight );
+        return;
+    }
+
+    uint16_t &texel = tile[ ((v & mask) << gnBinTileShift) + (u & mask) ];
+    const int sum   = texel + weight;
+    if( sum <= 0xFFFF )
+    {
+        texel = (uint16_t) sum;
+        return;
+    }
+
+// BEGIN OMP
+#pragma omp atomic
+// END OMP
+    gpCountTexels[ iTexel ] += sum;
+    texel = 0;
+}
+
+
+// Apply a thread's staged deposits one tile at a time.
+// A counting sort (one radix digit = the tile #) partitions them by tile.
+// ========================================================================
+void Staging_Flush( Staging &staging )
+{
+    uint32_t *aStart = staging.aStart;
+    memset( aStart, 0, (gnBinTiles + 1) * sizeof( uint32_t ) );
+
+    for( size_t iEntry = 0; iEntry < staging.nEntry; iEntry++ )
+        aStart[ (staging.aEntry[ iEntry ] >> 48) + 1 ]++;
+
+    for( int iTile = 0; iTile < gnBinTiles; iTile++ )
+        aStart[ iTile + 1 ] += aStart[ iTile ];
+
+    for( size_t iEntry = 0; iEntry < staging.nEntry; iEntry++ )
+    {
+        const uint64_t entry = staging.aEntry[ iEntry ];
+        staging.aSorted[ aStart[ entry >> 48 ]++ ] = entry;
+    }
+
+    for( size_t iEntry = 0; iEntry < staging.nEntry; iEntry++ )
+    {
+        const uint64_t entry = staging.aSorted[ iEntry ];
+        if( gnAccumulate == ACCUMULATE_ATOMIC )
+            deposit_atomic( staging.stripe, (uint32_t) entry, (uint16_t)(entry >> 32) );
+        else
+        if( gnAccumulate == ACCUMULATE_BYTES )
+            deposit_byte  ( gaThreadsBytes[ staging.iThread ], (uint32_t) entry, (uint16_t)(entry >> 32) );
+        else
+            deposit_texel ( staging.texels, (uint32_t) entry, (uint16_t)(entry >> 32) );
+    }
+
+    staging.nEntry = 0;
+}
+
+
+// Add all the parcels waiting in this thread's inbox to the counts of the tiles it owns
+// ========================================================================
+void Owner_Drain( const int iTid )
+{
+    Parcel *parcel = gaThreadsMailbox[ iTid ].pInbox.exchange( NULL, std::memory_order_acquire );
+
+    while( parcel )
+    {
+        Parcel *next  = parcel->pNext; // parcel is gone once its batch is returned
+        Batch  *batch = parcel->pBatch;
+
+        for( uint32_t iEntry = parcel->iBegin; iEntry < parcel->iEnd; iEntry++ )
+        {
+            const uint64_t entry = batch->aEntry[ iEntry ];
+            gpCountTexels[ (uint32_t) entry ] += (uint16_t)(entry >> 32);
+        }
+
+        if( batch->nParcels.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+        {
+            std::atomic<Batch*> &free = gaThreadsMailbox[ batch->iProducer ].pFree;
+            batch->pNext = free.load( std::memory_order_relaxed );
+            while( !free.compare_exchange_weak( batch->pNext, batch, std::memory_order_release, std::memory_order_relaxed ) )
+                ;
+        }
+
+        parcel = next;
+    }
+}
+
+
+// Partition a thread's staged deposits by owner (and by tile within each owner)
+// into a free batch and send each owner its parcel.
+// While all of its batches are in flight a thread applies its own inbox; since
+// every thread does the same, some batch is always on its way back.
+// ========================================================================
+void Owner_Ship( Staging &staging )
+{
+    const int iTid = staging.iThread;
+    Mailbox &mailbox = gaThreadsMailbox[ iTid ];
+
+    while( !mailbox.pSpare )
+    {
+        mailbox.pSpare = mailbox.pFree.exchange( NULL, std::memory_order_acquire );
+        if( !mailbox.pSpare )
+        {
+            Owner_Drain( iTid );
+            std::this_thread::yield();
+        }
+    }
+
+    Batch *batch = mailbox.pSpare;
+    mailbox.pSpare = batch->pNext;
+
+    // Counting sort, with the tiles visited owner by owner when laying out the offsets
+    const int nOwners = gnThreadsActive;
+    uint32_t *aStart  = staging.aStart;
+    uint32_t *aOwner  = staging.aOwner;
+    memset( aStart, 0, (gnBinTiles + 1) * sizeof( uint32_t ) );
+
+    for( size_t iEntry = 0; iEntry < staging.nEntry; iEntry++ )
+        aStart[ staging.aEntry[ iEntry ] >> 48 ]++;
+
+    uint32_t nOffset = 0;
+    for( int iOwner = 0; iOwner < nOwners; iOwner++ )
+    {
+        aOwner[ iOwner ] = nOffset;
+        for( int iTile = iOwner; iTile < gnBinTiles; iTile += nOwners )
+        {
+            const uint32_t n = aStart[ iTile ];
+            aStart[ iTile ] = nOffset;
+            nOffset += n;
+        }
+    }
+    aOwner[ nOwners ] = nOffset;
+
+    for( size_t iEntry = 0; iEntry < staging.nEntry; iEntry++ )
+    {
+        const uint64_t entry = staging.aEntry[ iEntry ];
+        batch->aEntry[ aStart[ entry >> 48 ]++ ] = entry;
+    }
+
+    staging.nEntry = 0;
+
+    int nParcels = 0;
+    for( int iOwner = 0; iOwner < nOwners; iOwner++ )
+        if( aOwner[ iOwner ] < aOwner[ iOwner + 1 ] )
+            nParcels++;
+
+    batch->nParcels.store( nParcels, std::memory_order_relaxed );
+
+    for( int iOwner = 0; iOwner < nOwners; iOwner++ )
+    {
+        if( aOwner[ iOwner ] == aOwner[ iOwner + 1 ] )
+            continue;
+
+        Parcel &parcel = batch->aParcel[ iOwner ];
+        parcel.pBatch = batch;
+        parcel.iBegin = aOwner[ iOwner     ];
+        parcel.iEnd   = aOwner[ iOwner + 1 ];
+
+        std::atomic<Parcel*> &inbox = gaThreadsMailbox[ iOwner ].pInbox;
+        parcel.pNext = inbox.load( std::memory_order_relaxed );
+        while( !inbox.compare_exchange_weak( parcel.pNext, &parcel, std::memory_order_release, std::memory_order_relaxed ) )
+            ;
+    }
+
+    if( !nParcels )
+    {
+        batch->pNext   = mailbox.pSpare;
+        mailbox.pSpare = batch;
+    }
+
+    // Keep our own tiles moving so producers don't stall on us
+    Owner_Drain( iTid );
+}
+
+
+// @param u,v    texel, must be in the image
+// @param width  image width
+// @param weight Seeds this one stands for
+// ========================================================================
+inline
+void deposit( uint16_t *texels, const int u, const int v, const int width, const int weight )
+{
+    const int iTexel = Layout_Index( u, v, width, gnHeight );
+
+    if( !gbBinning )
+    {
+        if( gnAccumulate == ACCUMULATE_ATOMIC )
+            deposit_atomic( gpStripe, iTexel, weight );
+        else
+        if( gnAccumulate == ACCUMULATE_BYTES )
+            deposit_byte  ( *gpBytes, iTexel, weight );
+        else
+        if( gnAccumulate == ACCUMULATE_SPARSE )
+        {
+            if( gpSparse->texels )
+                deposit_texel ( gpSparse->texels, iTexel, weight );
+            else
+                deposit_sparse( *gpSparse, u, v, iTexel, weight );
+        }
+        else
+            deposit_texel ( texels  , iTexel, weight );
+        return;
+    }
+
+    Staging &staging = *gpStaging;
+    const uint64_t tile = ((v >> gnBinTileShift) * gnBinTilesX) + (u >> gnBinTileShift);
+
+    staging.aEntry[ staging.nEntry++ ] = (uint64_t)iTexel | ((uint64_t)weight << 32) | (tile << 48);
+    if( staging.nEntry == (size_t)gnBinEntries )
+    {
+        if( gnAccumulate == ACCUMULATE_OWNER )
+            Owner_Ship   ( staging );
+        else
+            Staging_Flush( staging );
+    }
+}
+
+
+// @param wx World X start location
+// @param wy World Y start location
+// @param sx World to Image scale X
 // @param sy World to Image scale Y
+// @param mirror Also deposit the conjugate orbit of seed <wx,-wy>
+// @param weight Seeds this one stands for
 // ========================================================================
 inline
-void plot( double wx, double wy, double sx, double sy, uint16_t *texels, const int width, const int height, const int maxdepth )
+void plot( double wx, double wy, double sx, double sy, uint16_t *texels, const int width, const int height, const int maxdepth, const bool mirror, const int weight )
 {
     double  r = 0., i = 0.; // Zn   current Complex< real, imaginary >
     double  s     , j     ; // Zn+1 next    Complex< real, imaginary >
@@ -489,118 +1948,2484 @@ void plot( double wx, double wy, double sx, double sy, uint16_t *texels, const i
         r = s;
         i = j;
 
-        // Optimizaton: We don't need to re-check since we already know
-        //   a) that this point escapes, and
-        //   b) the maxdepth
-        //if ((r*r + i*i) > 4.0 ) // escapes to infinity, don't render
-        //    return;
+        // Optimizaton: We don't need to re-check since we already know
+        //   a) that this point escapes, and
+        //   b) the maxdepth
+        //if ((r*r + i*i) > 4.0 ) // escapes to infinity, don't render
+        //    return;
+
+        u = (int) ((r - gnWorldMinX) * sx); // texel x
+        v = (int) ((i - gnWorldMinY) * sy); // texel y
+
+        if( (u < width) && (v < height) && (u >= 0) && (v >= 0) )
+            deposit( texels, u, v, width, weight );
+
+        if( mirror ) // conjugate orbit of the mirrored seed
+        {
+            v = (int) ((-i - gnWorldMinY) * sy); // texel y
+            if( (u < width) && (v < height) && (u >= 0) && (v >= 0) )
+                deposit( texels, u, v, width, weight );
+        }
+    }
+}
+
+
+// Deposit a recorded orbit instead of re-iterating it
+// @param orbit  Zn interleaved as real, imaginary
+// @param count  Number of points in the orbit
+// @param mirror Also deposit the conjugate orbit
+// @param weight Seeds this one stands for
+// ========================================================================
+inline
+void plot_orbit( const double *orbit, const int count, double sx, double sy, uint16_t *texels, const int width, const int height, const bool mirror, const int weight )
+{
+    int     u     , v     ; // texel coords
+
+    for( int depth = 0; depth < count; depth++ )
+    {
+        const double r = orbit[ 2*depth + 0 ];
+        const double i = orbit[ 2*depth + 1 ];
+
+        u = (int) ((r - gnWorldMinX) * sx); // texel x
+        v = (int) ((i - gnWorldMinY) * sy); // texel y
+
+        if( (u < width) && (v < height) && (u >= 0) && (v >= 0) )
+            deposit( texels, u, v, width, weight );
+
+        if( mirror ) // conjugate orbit of the mirrored seed
+        {
+            v = (int) ((-i - gnWorldMinY) * sy); // texel y
+            if( (u < width) && (v < height) && (u >= 0) && (v >= 0) )
+                deposit( texels, u, v, width, weight );
+        }
+    }
+}
+
+
+// Deposit an orbit with a fractional weight per point
+// @param maxdepth Iteration the orbit escaped at
+// ========================================================================
+inline
+void plot_weighted( double wx, double wy, double sx, double sy, double *weights, const int width, const int height, const int maxdepth, const double weight )
+{
+    double  r = 0., i = 0.; // Zn   current Complex< real, imaginary >
+    double  s     , j     ; // Zn+1 next    Complex< real, imaginary >
+    int     u     , v     ; // texel coords
+
+    for( int depth = 0; depth <= maxdepth; depth++ ) // Note: <=
+    {
+        s = (r*r - i*i) + wx;
+        j = (2.0*r*i)   + wy;
+
+        r = s;
+        i = j;
+
+        u = (int) ((r - gnWorldMinX) * sx); // texel x
+        v = (int) ((i - gnWorldMinY) * sy); // texel y
+
+        if( (u < width) && (v < height) && (u >= 0) && (v >= 0) )
+            weights[ Layout_Index( u, v, width, height ) ] += weight;
+    }
+}
+
+
+// Seed stream: linear seed index -> world position
+// ========================================================================
+struct SeedSource
+{
+    int      type; // SEED_*
+
+    // SEED_GRID
+    size_t   nCol; // scaled width
+    double   dx  ; // world distance between columns
+    double   dy  ; // world distance between rows
+
+    // SEED_RANDOM, SEED_SOBOL
+    uint64_t key ; // Philox key
+    uint64_t shiftU, shiftV; // Sobol digital shift
+    double   minY; // domain MinY, or 0 when sampling the upper half only (symmetry)
+    double   w   ; // domain area sampled
+    double   h   ;
+
+    // SEED_ADAPTIVE: every stride'th grid seed of a run of cells, starting at <col0,row0>
+    size_t   col0  ;
+    size_t   row0  ;
+    size_t   nRun  ; // seeds per row of the run
+    size_t   stride;
+
+    // SEED_RESUME: positions come from the source of the run that saved them
+    const PendingSeed *aPending;
+    int      base  ; // SEED_GRID, SEED_RANDOM or SEED_SOBOL
+
+    int      weight; // grid seeds each seed stands for
+
+    // @return index that identifies the seed in its source, independent of the work list
+    inline uint64_t Index( const size_t iSeed ) const
+    {
+        if( type == SEED_RESUME )
+            return aPending[ iSeed ].index;
+
+        if( type == SEED_ADAPTIVE )
+            return (row0 + (iSeed / nRun) * stride) * nCol + col0 + (iSeed % nRun) * stride;
+
+        return iSeed;
+    }
+
+    // Starting Zn
+    // @return depth the seed has already been iterated to
+    inline int Start( const size_t iSeed, double *r_, double *i_ ) const
+    {
+        if( type == SEED_RESUME )
+        {
+            *r_ = aPending[ iSeed ].r;
+            *i_ = aPending[ iSeed ].i;
+            return gnPendingDepth;
+        }
+
+        *r_ = 0.;
+        *i_ = 0.;
+        return 0;
+    }
+
+    inline void Seed( size_t iSeed, double *x_, double *y_ ) const
+    {
+        int source = type;
+        if( type == SEED_RESUME )
+        {
+            source = base;
+            iSeed  = aPending[ iSeed ].index;
+        }
+
+        if( source == SEED_RANDOM )
+        {
+            double u, v;
+            Philox_Uniform2( iSeed, key, &u, &v );
+
+            *x_ = gnDomainMinX + (u * w);
+            *y_ = minY        + (v * h);
+            return;
+        }
+
+        if( source == SEED_SOBOL )
+        {
+            double u, v;
+            Sobol_Uniform2( iSeed, shiftU, shiftV, &u, &v );
+
+            *x_ = gnDomainMinX + (u * w);
+            *y_ = minY        + (v * h);
+            return;
+        }
+
+        size_t iCol, iRow;
+
+        if( source == SEED_ADAPTIVE )
+        {
+            iCol = col0 + (iSeed % nRun) * stride;
+            iRow = row0 + (iSeed / nRun) * stride;
+        }
+        else
+        {
+            iCol = iSeed % nCol;
+            iRow = iSeed / nCol;
+        }
+
+        *x_ = gnDomainMinX + (iCol * dx);
+        *y_ = gnDomainMinY + (iRow * dy);
+    }
+};
+
+
+// A contiguous range of seeds
+// ========================================================================
+struct WorkItem
+{
+    size_t iBegin;
+    size_t iEnd  ;
+    bool   mirror; // also deposit conjugate orbits
+
+    // SEED_ADAPTIVE
+    size_t col0  ;
+    size_t row0  ;
+    size_t nRun  ;
+    int    stride;
+
+    int    weight; // SEED_ADAPTIVE, SEED_RESUME
+    int    band  ; // SEED_GRID: image row the seeds are in, for the cost map
+    int    id    ; // position in the order the items were built, for the checkpoint bitmap
+};
+
+
+// Iterate seeds [iBegin,iEnd) one at a time
+// ========================================================================
+void Escape_Scalar( const SeedSource &seeds, const size_t iBegin, const size_t iEnd, const double sx, const double sy, const int iTid, const bool mirror )
+{
+    /* */ uint16_t    *texels = gaThreadsTexels[ iTid ];
+    /* */ ThreadStats &stats  = gaThreadsStats [ iTid ];
+    /* */ double      *orbit  = gaThreadsOrbit [ iTid ];
+    const int          nCache = orbit ? gnOrbitCapacity : 0; // iterations we can record
+
+    for( size_t iSeed = iBegin; iSeed < iEnd; iSeed++ )
+    {
+        double x, y;
+        seeds.Seed( iSeed, &x, &y );
+
+        if( gbCullInterior && Interior( x, y ) )
+        {
+            stats.nCulled++;
+            continue;
+        }
+
+        /* */ double    r, i, s, j;
+        /* */ int       depth   = seeds.Start( iSeed, &r, &i );
+        const int       nRecord = depth ? 0 : nCache; // a resumed orbit's start isn't in the cache
+
+        Periodicity cycle;
+        cycle.Reset();
+        cycle.pr = r;
+        cycle.pi = i;
+
+            // Record the orbit while it still fits ...
+            for( ; depth < nRecord; depth++ )
+            {
+                s = (r*r - i*i) + x; // Zn+1 = Zn^2 + C<x,y>
+                j = (2.0*r*i)   + y;
+
+                r = s;
+                i = j;
+
+                orbit[ 2*depth + 0 ] = r;
+                orbit[ 2*depth + 1 ] = i;
+
+                if ((r*r + i*i) > 4.0) // escapes to infinity so trace path
+                {
+                    plot_orbit( orbit, depth + 1, sx, sy, texels, gnWidth, gnHeight, mirror, seeds.weight );
+                    stats.nOrbitCached++;
+                    stats.nEscaped++;
+                    break;
+                }
+
+                if( gbPeriodic && cycle.Cycle( r, i, x, y ) )
+                {
+                    stats.nPeriodic++;
+                    break;
+                }
+            }
+
+            if( depth < nRecord )
+                continue;
+
+            // ... then fall back to re-iterating it
+            for ( ; depth < gnMaxDepth; depth++)
+            {
+                s = (r*r - i*i) + x; // Zn+1 = Zn^2 + C<x,y>
+                j = (2.0*r*i)   + y;
+
+                r = s;
+                i = j;
+
+                if ((r*r + i*i) > 4.0) // escapes to infinity so trace path
+                {
+                    plot( x, y, sx, sy, texels, gnWidth, gnHeight, depth, mirror, seeds.weight );
+                    stats.nEscaped++;
+                    break;
+                }
+
+                if( gbPeriodic && cycle.Cycle( r, i, x, y ) )
+                {
+                    stats.nPeriodic++;
+                    break;
+                }
+            }
+
+            if( gpFileNamePending && (depth == gnMaxDepth) )
+                Pending_Add( iTid, seeds.Index( iSeed ), r, i, seeds.weight, mirror );
+    }
+}
+
+
+// BEGIN SIMD
+#if SIMD_X86
+
+// Each lane holds one seed. The vector loop runs until either a lane escapes
+// or the lane with the least remaining depth runs out; only then do we drop
+// to scalar code to plot/retire that lane and refill it from the seed stream.
+// Inactive lanes (seed stream exhausted) are parked at C = 0 which never escapes.
+//
+// The vector math is the exact same sequence of IEEE-754 operations as
+// Escape_Scalar() so the output is bit-identical.
+//
+// When orbit caching is on every step is stored into a ring of gnOrbitRing
+// rows x 8 lanes. A lane's orbit starts at the row it was refilled on and
+// is only overwritten after gnOrbitRing more steps, so any orbit that is
+// no longer than the ring can be deposited straight from it.
+//
+// When periodicity checking is on each lane keeps its own Brent window; the
+// vector loop also stops when a lane reaches the end of its window or comes
+// within tolerance of its saved point. Inactive lanes save NaN which never matches.
+// ========================================================================
+struct EscapeLanes
+{
+    enum { MAX_LANES = 8 };
+
+    double x[ MAX_LANES ]; // C
+    double y[ MAX_LANES ];
+    double r[ MAX_LANES ]; // Zn
+    double i[ MAX_LANES ];
+    int    n[ MAX_LANES ]; // iterations done so far; INT_MAX = inactive
+    size_t t[ MAX_LANES ]; // ring row of first iteration
+    double pr[ MAX_LANES ]; // Periodicity: saved Zm
+    double pi[ MAX_LANES ];
+    int    ps[ MAX_LANES ]; // Periodicity: iteration of Zm
+    int    pw[ MAX_LANES ]; // Periodicity: window length
+    size_t k[ MAX_LANES ]; // seed #
+
+    const SeedSource  &seeds;
+    /* */ size_t       iNext;
+    const size_t       iEnd;
+    /* */ int          nActive;
+
+    /* */ uint16_t    *texels;
+    /* */ ThreadStats &stats;
+    /* */ double      *ringR; // [ row ][ lane ] NULL = re-iterate orbits
+    /* */ double      *ringI;
+    const size_t       nRing; // rows, power of 2
+    /* */ size_t       iStep; // total steps taken == next ring row
+
+    const double       sx;    // World to Image scale
+    const double       sy;
+    const bool         mirror; // also deposit conjugate orbits
+    const int          iTid;
+
+    EscapeLanes( const SeedSource &seeds_, const size_t iBegin, const size_t iEnd_, const int nLanes, const double sx_, const double sy_, const int iTid_, const bool mirror_ )
+        : seeds( seeds_ ), iNext( iBegin ), iEnd( iEnd_ ), nActive( 0 )
+        , texels( gaThreadsTexels[ iTid_ ] )
+        , stats ( gaThreadsStats [ iTid_ ] )
+        , ringR ( gaThreadsOrbit [ iTid_ ] )
+        , ringI ( ringR ? ringR + gnOrbitRing*MAX_LANES : NULL )
+        , nRing ( gnOrbitRing )
+        , iStep ( 0 )
+        , sx( sx_ ), sy( sy_ ), mirror( mirror_ ), iTid( iTid_ )
+    {
+        for( int iLane = 0; iLane < nLanes; iLane++ )
+            Refill( iLane );
+    }
+
+    inline void Refill( const int iLane )
+    {
+        r[ iLane ] = 0.;
+        i[ iLane ] = 0.;
+        t[ iLane ] = iStep;
+
+        pr[ iLane ] = 0.;
+        pi[ iLane ] = 0.;
+        ps[ iLane ] = 0;
+        pw[ iLane ] = 1;
+
+        while( iNext < iEnd )
+        {
+            k[ iLane ] = iNext++;
+            seeds.Seed( k[ iLane ], &x[ iLane ], &y[ iLane ] );
+
+            if( gbCullInterior && Interior( x[ iLane ], y[ iLane ] ) )
+            {
+                stats.nCulled++;
+                continue;
+            }
+
+            n [ iLane ] = seeds.Start( k[ iLane ], &r[ iLane ], &i[ iLane ] );
+            pr[ iLane ] = r[ iLane ];
+            pi[ iLane ] = i[ iLane ];
+            ps[ iLane ] = n[ iLane ];
+            nActive++;
+            return;
+        }
+
+        x[ iLane ] = 0.;
+        y[ iLane ] = 0.;
+        n[ iLane ] = INT_MAX;
+
+        pr[ iLane ] = NAN;
+        pi[ iLane ] = NAN;
+    }
+
+    // @return maximum number of iterations before some active lane hits max depth or the end of its Brent window
+    inline int Steps( const int nLanes ) const
+    {
+        int nSteps = INT_MAX;
+        for( int iLane = 0; iLane < nLanes; iLane++ )
+        {
+            if( n[ iLane ] == INT_MAX )
+                continue;
+
+            if( (gnMaxDepth - n[ iLane ]) < nSteps )
+                nSteps = gnMaxDepth - n[ iLane ];
+
+            if( gbPeriodic && (ps[ iLane ] + pw[ iLane ] - n[ iLane ]) < nSteps )
+                nSteps = ps[ iLane ] + pw[ iLane ] - n[ iLane ];
+        }
+        return nSteps;
+    }
+
+    inline void Plot( const int iLane )
+    {
+        const int count = n[ iLane ];
+
+        if( !ringR || (size_t)count > nRing || (seeds.type == SEED_RESUME) ) // a resumed orbit's start isn't in the ring
+        {
+            plot( x[ iLane ], y[ iLane ], sx, sy, texels, gnWidth, gnHeight, count - 1, mirror, seeds.weight );
+            return;
+        }
+
+        const size_t mask = nRing - 1;
+        for( int depth = 0; depth < count; depth++ )
+        {
+            const size_t row = ((t[ iLane ] + depth) & mask) * MAX_LANES + iLane;
+            const double rr  = ringR[ row ];
+            const double ii  = ringI[ row ];
+
+            const int u = (int) ((rr - gnWorldMinX) * sx); // texel x
+            const int v = (int) ((ii - gnWorldMinY) * sy); // texel y
+
+            if( (u < gnWidth) && (v < gnHeight) && (u >= 0) && (v >= 0) )
+                deposit( texels, u, v, gnWidth, seeds.weight );
+
+            if( mirror ) // conjugate orbit of the mirrored seed
+            {
+                const int w = (int) ((-ii - gnWorldMinY) * sy); // texel y
+                if( (u < gnWidth) && (w < gnHeight) && (u >= 0) && (w >= 0) )
+                    deposit( texels, u, w, gnWidth, seeds.weight );
+            }
+        }
+        stats.nOrbitCached++;
+    }
+
+    // @param nSteps  iterations the vector loop actually ran
+    // @param escaped bit mask of lanes whose |Zn| > 2 on the last iteration
+    // @param cycled  bit mask of lanes whose Zn is within tolerance of the saved Zm
+    inline void Retire( const int nLanes, const int nSteps, const int escaped, const int cycled )
+    {
+        for( int iLane = 0; iLane < nLanes; iLane++ )
+        {
+            if( n[ iLane ] == INT_MAX )
+                continue;
+
+            n[ iLane ] += nSteps;
+
+            if( (escaped >> iLane) & 1 )
+            {
+                Plot( iLane );
+                stats.nEscaped++;
+                nActive--;
+                Refill( iLane );
+            }
+            else
+            if( ((cycled >> iLane) & 1) && Periodic_Confirm( pr[ iLane ], pi[ iLane ], x[ iLane ], y[ iLane ], r[ iLane ], i[ iLane ], n[ iLane ] - ps[ iLane ] ) )
+            {
+                stats.nPeriodic++;
+                nActive--;
+                Refill( iLane );
+            }
+            else
+            if( n[ iLane ] >= gnMaxDepth )
+            {
+                if( gpFileNamePending )
+                    Pending_Add( iTid, seeds.Index( k[ iLane ] ), r[ iLane ], i[ iLane ], seeds.weight, mirror );
+                nActive--;
+                Refill( iLane );
+            }
+            else
+            if( (cycled >> iLane) & 1 ) // not trapped (yet); restart the window from here
+            {
+                pr[ iLane ]  = r[ iLane ];
+                pi[ iLane ]  = i[ iLane ];
+                ps[ iLane ]  = n[ iLane ];
+            }
+            else
+            if( gbPeriodic && (n[ iLane ] == ps[ iLane ] + pw[ iLane ]) )
+            {
+                pr[ iLane ]  = r[ iLane ];
+                pi[ iLane ]  = i[ iLane ];
+                ps[ iLane ]  = n[ iLane ];
+                pw[ iLane ] *= 2;
+            }
+        }
+    }
+};
+
+
+// Iterate seeds [iBegin,iEnd) four at a time
+// ========================================================================
+TARGET_AVX2
+void Escape_AVX2( const SeedSource &seeds, const size_t iBegin, const size_t iEnd, const double sx, const double sy, const int iTid, const bool mirror )
+{
+    const int   nLanes = 4;
+    EscapeLanes lanes( seeds, iBegin, iEnd, nLanes, sx, sy, iTid, mirror );
+
+    const __m256d two  = _mm256_set1_pd( 2.0 );
+    const __m256d four = _mm256_set1_pd( 4.0 );
+    const __m256d tol2 = _mm256_set1_pd( gnPeriodTolerance2 );
+    const size_t  mask = lanes.nRing - 1;
+
+    while( lanes.nActive )
+    {
+        const int nSteps = lanes.Steps( nLanes );
+
+        __m256d x = _mm256_loadu_pd( lanes.x );
+        __m256d y = _mm256_loadu_pd( lanes.y );
+        __m256d r = _mm256_loadu_pd( lanes.r );
+        __m256d i = _mm256_loadu_pd( lanes.i );
+
+        const __m256d pr = _mm256_loadu_pd( lanes.pr );
+        const __m256d pi = _mm256_loadu_pd( lanes.pi );
+
+        int iStep   = 0;
+        int escaped = 0;
+        int cycled  = 0;
+
+        while( iStep < nSteps )
+        {
+            const __m256d s = _mm256_add_pd( _mm256_sub_pd( _mm256_mul_pd( r, r ), _mm256_mul_pd( i, i ) ), x ); // (r*r - i*i) + x
+            const __m256d j = _mm256_add_pd( _mm256_mul_pd( _mm256_mul_pd( two, r ), i ), y );                  // (2.0*r*i)   + y
+
+            r = s;
+            i = j;
+            iStep++;
+
+            if( lanes.ringR )
+            {
+                const size_t row = (lanes.iStep++ & mask) * EscapeLanes::MAX_LANES;
+                _mm256_storeu_pd( lanes.ringR + row, r );
+                _mm256_storeu_pd( lanes.ringI + row, i );
+            }
+
+            const __m256d m = _mm256_add_pd( _mm256_mul_pd( r, r ), _mm256_mul_pd( i, i ) );
+            escaped = _mm256_movemask_pd( _mm256_cmp_pd( m, four, _CMP_GT_OQ ) );
+
+            if( gbPeriodic )
+            {
+                const __m256d dr = _mm256_sub_pd( r, pr );
+                const __m256d di = _mm256_sub_pd( i, pi );
+                const __m256d d  = _mm256_add_pd( _mm256_mul_pd( dr, dr ), _mm256_mul_pd( di, di ) );
+                cycled = _mm256_movemask_pd( _mm256_cmp_pd( d, tol2, _CMP_LE_OQ ) );
+            }
+
+            if( escaped | cycled )
+                break;
+        }
+
+        _mm256_storeu_pd( lanes.r, r );
+        _mm256_storeu_pd( lanes.i, i );
+
+        lanes.Retire( nLanes, iStep, escaped, cycled );
+    }
+}
+
+
+// Iterate seeds [iBegin,iEnd) eight at a time
+// ========================================================================
+TARGET_AVX512
+void Escape_AVX512( const SeedSource &seeds, const size_t iBegin, const size_t iEnd, const double sx, const double sy, const int iTid, const bool mirror )
+{
+    const int   nLanes = 8;
+    EscapeLanes lanes( seeds, iBegin, iEnd, nLanes, sx, sy, iTid, mirror );
+
+    const __m512d two  = _mm512_set1_pd( 2.0 );
+    const __m512d four = _mm512_set1_pd( 4.0 );
+    const __m512d tol2 = _mm512_set1_pd( gnPeriodTolerance2 );
+    const size_t  mask = lanes.nRing - 1;
+
+    while( lanes.nActive )
+    {
+        const int nSteps = lanes.Steps( nLanes );
+
+        __m512d x = _mm512_loadu_pd( lanes.x );
+        __m512d y = _mm512_loadu_pd( lanes.y );
+        __m512d r = _mm512_loadu_pd( lanes.r );
+        __m512d i = _mm512_loadu_pd( lanes.i );
+
+        const __m512d pr = _mm512_loadu_pd( lanes.pr );
+        const __m512d pi = _mm512_loadu_pd( lanes.pi );
+
+        int iStep   = 0;
+        int escaped = 0;
+        int cycled  = 0;
+
+        while( iStep < nSteps )
+        {
+            const __m512d s = _mm512_add_pd( _mm512_sub_pd( _mm512_mul_pd( r, r ), _mm512_mul_pd( i, i ) ), x ); // (r*r - i*i) + x
+            const __m512d j = _mm512_add_pd( _mm512_mul_pd( _mm512_mul_pd( two, r ), i ), y );                  // (2.0*r*i)   + y
+
+            r = s;
+            i = j;
+            iStep++;
+
+            if( lanes.ringR )
+            {
+                const size_t row = (lanes.iStep++ & mask) * EscapeLanes::MAX_LANES;
+                _mm512_storeu_pd( lanes.ringR + row, r );
+                _mm512_storeu_pd( lanes.ringI + row, i );
+            }
+
+            const __m512d m = _mm512_add_pd( _mm512_mul_pd( r, r ), _mm512_mul_pd( i, i ) );
+            escaped = (int) _mm512_cmp_pd_mask( m, four, _CMP_GT_OQ );
+
+            if( gbPeriodic )
+            {
+                const __m512d dr = _mm512_sub_pd( r, pr );
+                const __m512d di = _mm512_sub_pd( i, pi );
+                const __m512d d  = _mm512_add_pd( _mm512_mul_pd( dr, dr ), _mm512_mul_pd( di, di ) );
+                cycled = (int) _mm512_cmp_pd_mask( d, tol2, _CMP_LE_OQ );
+            }
+
+            if( escaped | cycled )
+                break;
+        }
+
+        _mm512_storeu_pd( lanes.r, r );
+        _mm512_storeu_pd( lanes.i, i );
+
+        lanes.Retire( nLanes, iStep, escaped, cycled );
+    }
+}
+
+#endif // SIMD_X86
+
+
+
+// @return the widest escape engine this CPU supports
+// ========================================================================
+int Escape_DetectEngine()
+{
+#if SIMD_X86
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx512f" ) ) return ESCAPE_AVX512;
+    if( __builtin_cpu_supports( "avx2"    ) ) return ESCAPE_AVX2;
+#endif
+    return ESCAPE_SCALAR;
+}
+// END SIMD
+
+
+// The orbit of the conjugate seed <x,-y> is exactly the conjugate orbit (negation is exact)
+// so if row K-k is the mirror image of row k we only need to iterate one of them.
+// y[k] = MinY + k*dy, y[K-k] = -y[k]  =>  K = -2*MinY / dy
+// @return K, or -1 if the seed rows aren't symmetric about the real axis
+// ========================================================================
+int Symmetry_MirrorRow( const double minY, const double dy, const size_t nRow )
+{
+    const double K = -2.0 * minY / dy;
+    const double k = floor( K + 0.5 );
+
+    if( fabs( K - k ) > 1e-6 )       // real axis not on (or exactly between) seed rows
+        return -1;
+
+    if( (k < 1) || (k > 2.0*(nRow - 1) - 1) ) // no row has its mirror in view
+        return -1;
+
+    return (int) k;
+}
+
+
+// Adaptive seed density
+//
+// A coarse escape time pass at the corners of every cell (pixel) of the seed
+// grid classifies it as
+//
+//   * interior : no corner escapes. Costs max depth per seed, plots nothing
+//                unless a filament or minibrot slips between the corners
+//   * exterior : every corner escapes in < ADAPTIVE_FAST_DEPTH, short orbits
+//   * boundary : everything else, and the neighbours of mixed cells
+//
+// Boundary cells keep all gnScale^2 seeds. The others only iterate every
+// stride'th seed in both directions, starting at a random offset, and deposit
+// with weight stride^2. As stride divides gnScale every grid seed is picked
+// with probability exactly 1/stride^2, so the expected image is the full grid's.
+// ========================================================================
+const int ADAPTIVE_FAST_DEPTH = 8;
+
+enum AdaptiveCell_e
+{
+     CELL_BOUNDARY = 0
+    ,CELL_INTERIOR
+    ,CELL_EXTERIOR
+    ,NUM_CELL_TYPES
+};
+
+// @return iterations until escape, gnMaxDepth if it doesn't
+// ========================================================================
+inline
+int Adaptive_EscapeDepth( const double x, const double y )
+{
+    if( gbCullInterior && Interior( x, y ) )
+        return gnMaxDepth;
+
+    double r = 0., i = 0., s, j;
+    int    depth = 0;
+
+    for( ; depth < gnMaxDepth; depth++ )
+    {
+        s = (r*r - i*i) + x; // Zn+1 = Zn^2 + C<x,y>
+        j = (2.0*r*i)   + y;
+
+        r = s;
+        i = j;
+
+        if ((r*r + i*i) > 4.0) // escapes to infinity
+            break;
+    }
+
+    return depth;
+}
+
+
+// @return largest divisor of n that is <= limit
+// ========================================================================
+int Adaptive_Divisor( const int n, const int limit )
+{
+    int best = 1;
+    for( int d = 1; d <= n && d <= limit; d++ )
+        if( (n % d) == 0 )
+            best = d;
+    return best;
+}
+
+
+// Escape map pre-pass, then runs of cells with the same stride become the work list
+// @param nCells_ Out: cells of each type
+// @return Work list, free() when done
+// ========================================================================
+WorkItem* Adaptive_BuildWork( const SeedSource &seeds, int *nWork_, int aStride_[ NUM_CELL_TYPES ], int nCells_[ NUM_CELL_TYPES ] )
+{
+    const int nProbeW = gnWidth  + 1;
+    const int nProbeH = gnHeight + 1;
+
+    // 1. Escape depth at the cell corners
+    int *aDepth = (int*) malloc( nProbeW * nProbeH * sizeof( int ) );
+
+// BEGIN OMP
+#pragma omp parallel for schedule(dynamic)
+// END OMP
+    for( int py = 0; py < nProbeH; py++ )
+        for( int px = 0; px < nProbeW; px++ )
+        {
+            const double x = gnDomainMinX + ((size_t)px * gnScale) * seeds.dx;
+            const double y = gnDomainMinY + ((size_t)py * gnScale) * seeds.dy;
+            aDepth[ py*nProbeW + px ] = Adaptive_EscapeDepth( x, y );
+        }
+
+    // 2. Classify
+    uint8_t *aType  = (uint8_t*) malloc( gnWidth * gnHeight );
+    uint8_t *aMixed = (uint8_t*) malloc( gnWidth * gnHeight );
+
+    for( int cy = 0; cy < gnHeight; cy++ )
+        for( int cx = 0; cx < gnWidth; cx++ )
+        {
+            const int *pCorner = &aDepth[ cy*nProbeW + cx ];
+            const int  aCorner[4] = { pCorner[ 0 ], pCorner[ 1 ], pCorner[ nProbeW ], pCorner[ nProbeW + 1 ] };
+
+            int nInside = 0, nDeepest = 0;
+            for( int k = 0; k < 4; k++ )
+            {
+                if( aCorner[ k ] >= gnMaxDepth )
+                    nInside++;
+                else
+                if( nDeepest < aCorner[ k ] )
+                    nDeepest = aCorner[ k ];
+            }
+
+            const int iCell = cy*gnWidth + cx;
+            aMixed[ iCell ] = (nInside > 0) && (nInside < 4);
+
+            if( nInside == 4 )
+                aType[ iCell ] = CELL_INTERIOR;
+            else
+            if( (nInside == 0) && (nDeepest < ADAPTIVE_FAST_DEPTH) )
+                aType[ iCell ] = CELL_EXTERIOR;
+            else
+                aType[ iCell ] = CELL_BOUNDARY;
+        }
+
+    // The boundary can wander a cell either side of where the corners say it is
+    for( int cy = 0; cy < gnHeight; cy++ )
+        for( int cx = 0; cx < gnWidth; cx++ )
+            for( int ny = cy-1; ny <= cy+1; ny++ )
+                for( int nx = cx-1; nx <= cx+1; nx++ )
+                    if( (nx >= 0) && (ny >= 0) && (nx < gnWidth) && (ny < gnHeight) && aMixed[ ny*gnWidth + nx ] )
+                        aType[ cy*gnWidth + cx ] = CELL_BOUNDARY;
+
+    // 3. Strides must divide gnScale; exterior cells get about half the thinning, in log terms
+    const int nMaxStride = (gnAdaptiveStride > 0) ? gnAdaptiveStride : gnScale;
+    aStride_[ CELL_BOUNDARY ] = 1;
+    aStride_[ CELL_INTERIOR ] = Adaptive_Divisor( gnScale, nMaxStride );
+    aStride_[ CELL_EXTERIOR ] = Adaptive_Divisor( gnScale, (int) sqrt( (double) aStride_[ CELL_INTERIOR ] ) );
+
+    for( int iType = 0; iType < NUM_CELL_TYPES; iType++ )
+        nCells_[ iType ] = 0;
+
+    // 4. Runs of cells in a row with the same stride
+    WorkItem *aWork = (WorkItem*) malloc( gnWidth * gnHeight * sizeof( WorkItem ) );
+    int       nWork = 0;
+
+    for( int cy = 0; cy < gnHeight; cy++ )
+    {
+        for( int cx = 0; cx < gnWidth; )
+        {
+            const int stride = aStride_[ aType[ cy*gnWidth + cx ] ];
+            int nRunCells = 0;
+
+            while( (cx + nRunCells < gnWidth) && (aStride_[ aType[ cy*gnWidth + cx + nRunCells ] ] == stride) )
+                nCells_[ aType[ cy*gnWidth + cx + nRunCells++ ] ]++;
+
+            double u, v;
+            Philox_Uniform2( (1ULL << 63) | ((uint64_t)cy << 32) | (uint64_t)cx, gnRandomKey, &u, &v );
+
+            WorkItem &work = aWork[ nWork++ ];
+            work.col0   = (size_t)cx * gnScale + (size_t)(u * stride);
+            work.row0   = (size_t)cy * gnScale + (size_t)(v * stride);
+            work.nRun   = (size_t)nRunCells * gnScale / stride;
+            work.stride = stride;
+            work.weight = stride * stride;
+            work.iBegin = 0;
+            work.iEnd   = work.nRun * (gnScale / stride);
+            work.mirror = false;
+
+            cx += nRunCells;
+        }
+    }
+
+    free( aMixed );
+    free( aType  );
+    free( aDepth );
+
+    *nWork_ = nWork;
+    return aWork;
+}
+
+
+// Metropolis-Hastings: instead of sampling seeds uniformly over the domain,
+// sample them in proportion to how many points their orbit plots in the view.
+//
+// f(c) = number of points of the escaping orbit of c inside the view, 0 if c
+// doesn't escape. Each step proposes either a fresh uniform seed (probability
+// METROPOLIS_LARGE) or a small mutation of the current one: a random direction
+// and a distance log-uniform between 10^-1 and 10^-5 of the view width.
+// Both proposals are symmetric so the move is accepted with probability f(c')/f(c).
+//
+// The chain visits c with density f(c)/Z, so each visit deposits its orbit
+// weighted by 1/f(c). The uniform proposals are also an unbiased estimate of
+// E[f] = Z/Area which scales the weighted image to what uniform sampling with
+// the same number of seeds would produce on average.
+// ========================================================================
+const double METROPOLIS_LARGE = 0.1;
+
+// @return f(c), and the depth the orbit escaped at
+// ========================================================================
+inline
+int Metropolis_Contribution( const double x, const double y, const double sx, const double sy, int *depth_ )
+{
+    if( (x < gnDomainMinX) || (x > gnDomainMaxX) || (y < gnDomainMinY) || (y > gnDomainMaxY) )
+        return 0;
+
+    if( gbCullInterior && Interior( x, y ) )
+        return 0;
+
+    double r = 0., i = 0., s, j;
+    int    nHits = 0;
+
+    for( int depth = 0; depth < gnMaxDepth; depth++ )
+    {
+        s = (r*r - i*i) + x; // Zn+1 = Zn^2 + C<x,y>
+        j = (2.0*r*i)   + y;
+
+        r = s;
+        i = j;
+
+        const int u = (int) ((r - gnWorldMinX) * sx); // texel x
+        const int v = (int) ((i - gnWorldMinY) * sy); // texel y
+
+        if( (u < gnWidth) && (v < gnHeight) && (u >= 0) && (v >= 0) )
+            nHits++;
+
+        if ((r*r + i*i) > 4.0) // escapes to infinity
+        {
+            *depth_ = depth;
+            return nHits;
+        }
+    }
+
+    return 0;
+}
+
+
+// Run one chain of nSteps samples. Random numbers are Philox keyed on the
+// chain so each chain is reproducible; the image depends on the number of chains.
+// ========================================================================
+void Metropolis_Chain( const uint64_t iChain, const uint64_t nSteps, const double sx, const double sy, const int iTid )
+{
+    /* */ double      *weights = gaThreadsWeights[ iTid ];
+    /* */ ThreadStats &stats   = gaThreadsStats  [ iTid ];
+
+    const double PI      = 3.141592653589793;
+    const double nRadius = 0.1 * (gnWorldMaxX - gnWorldMinX);
+    const double nW      = gnDomainMaxX - gnDomainMinX;
+    const double nH      = gnDomainMaxY - gnDomainMinY;
+
+    /* */ uint64_t nCounter = iChain << 40; // 2^40 random pairs per chain
+    /* */ uint64_t iStep    = 0;
+
+    double x = 0., y = 0., u, v;
+    int    f = 0, depth = 0;
+
+    // Start from the first uniform seed that contributes anything
+    for( ; (iStep < nSteps) && !f; iStep++ )
+    {
+        Philox_Uniform2( nCounter++, gnRandomKey, &u, &v );
+        x = gnDomainMinX + u*nW;
+        y = gnDomainMinY + v*nH;
+        f = Metropolis_Contribution( x, y, sx, sy, &depth );
+
+        stats.nUniform    ++;
+        stats.nUniformHits += f;
+    }
+    stats.nSamples += iStep;
+
+    if( !f )
+        return;
+
+    stats.nVisits   ++;
+    stats.nVisitHits += f;
+
+    uint64_t nHold = 1; // visits to the current state; deposited when we leave it
+
+    for( ; iStep < nSteps; iStep++ )
+    {
+        double nx, ny, accept;
+        int    nDepth = 0;
+
+        Philox_Uniform2( nCounter++, gnRandomKey, &u, &accept );
+        const bool bLarge = (u < METROPOLIS_LARGE);
+
+        Philox_Uniform2( nCounter++, gnRandomKey, &u, &v );
+        if( bLarge )
+        {
+            nx = gnDomainMinX + u*nW;
+            ny = gnDomainMinY + v*nH;
+        }
+        else
+        {
+            const double radius = nRadius * pow( 10.0, -4.0 * u );
+            nx = x + radius * cos( 2.0 * PI * v );
+            ny = y + radius * sin( 2.0 * PI * v );
+        }
+
+        const int nf = Metropolis_Contribution( nx, ny, sx, sy, &nDepth );
+
+        if( bLarge )
+        {
+            stats.nUniform    ++;
+            stats.nUniformHits += nf;
+        }
+        stats.nProposed++;
+
+        if( (nf >= f) || (accept * f < nf) )
+        {
+            plot_weighted( x, y, sx, sy, weights, gnWidth, gnHeight, depth, (double) nHold / f );
+            stats.nAccepted++;
+
+            x     = nx;
+            y     = ny;
+            f     = nf;
+            depth = nDepth;
+            nHold = 0;
+        }
+
+        nHold++;
+        stats.nVisits   ++;
+        stats.nVisitHits += f;
+        stats.nSamples   ++;
+
+        Progress_Add( iTid, 1 );
+    }
+
+    plot_weighted( x, y, sx, sy, weights, gnWidth, gnHeight, depth, (double) nHold / f );
+}
+
+
+// Sum the chains' weights and scale them to uniform sampling with nSamples seeds
+// ========================================================================
+void Metropolis_Gather( const uint64_t nSamples )
+{
+    ThreadStats total = {};
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+    {
+        total.nUniform     += gaThreadsStats[ iThread ].nUniform    ;
+        total.nUniformHits += gaThreadsStats[ iThread ].nUniformHits;
+        total.nVisits      += gaThreadsStats[ iThread ].nVisits     ;
+    }
+
+    const double nMeanF = total.nUniform ? (double) total.nUniformHits / total.nUniform : 0.;
+    const double nScale = total.nVisits  ? (nMeanF * nSamples) / total.nVisits : 0.;
+
+    const int nPix = gnWidth  * gnHeight; // Normal area
+    for( int iPix = 0; iPix < nPix; iPix++ )
+    {
+        double sum = 0.;
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+            sum += gaThreadsWeights[ iThread ][ iPix ];
+
+        gpCountTexels[ iPix ] += (uint64_t) floor( sum * nScale + 0.5 );
+    }
+}
+
+
+// Add texels [iBegin,iEnd) of nSrc 16-bit copies into the 64-bit pDst.
+// All the copies are summed in 32-bit first (256 threads x 65535 fits), so each
+// copy is read once and each count read and written once -- the same memory
+// traffic a pairwise tree would end with, in a single pass.
+// ========================================================================
+void Gather_Scalar( const uint16_t * const *aSrc, const int nSrc, uint64_t *pDst, const int iBegin, const int iEnd )
+{
+    const int BLOCK = 16;
+    uint32_t  aSum[ BLOCK ];
+
+    for( int iPix = iBegin; iPix < iEnd; iPix += BLOCK )
+    {
+        const int n = (iEnd - iPix < BLOCK) ? iEnd - iPix : BLOCK;
+
+        for( int i = 0; i < n; i++ )
+            aSum[ i ] = 0;
+
+        for( int iSrc = 0; iSrc < nSrc; iSrc++ )
+        {
+            const uint16_t *pSrc = aSrc[ iSrc ] + iPix;
+            for( int i = 0; i < n; i++ )
+                aSum[ i ] += pSrc[ i ];
+        }
+
+        for( int i = 0; i < n; i++ )
+            pDst[ iPix + i ] += aSum[ i ];
+    }
+}
+
+
+// BEGIN SIMD
+#if SIMD_X86
+// 16 texels at a time: 16-bit copies widened to 2 x 8 32-bit sums, then 4 x 4 64-bit counts
+// ========================================================================
+TARGET_AVX2
+void Gather_AVX2( const uint16_t * const *aSrc_, const int nSrc, uint64_t *pDst_, const int iBegin, const int iEnd )
+{
+    const uint16_t *aSrc[ MAX_THREADS ]; // locals: the vector stores may alias the caller's array
+    for( int iSrc = 0; iSrc < nSrc; iSrc++ )
+        aSrc[ iSrc ] = aSrc_[ iSrc ];
+
+    int iPix = iBegin;
+
+    for( ; iPix + 16 <= iEnd; iPix += 16 )
+    {
+        __m256i lo = _mm256_setzero_si256();
+        __m256i hi = _mm256_setzero_si256();
+
+        for( int iSrc = 0; iSrc < nSrc; iSrc++ )
+        {
+            const __m256i src = _mm256_loadu_si256( (const __m256i*)(aSrc[ iSrc ] + iPix) );
+            lo = _mm256_add_epi32( lo, _mm256_cvtepu16_epi32( _mm256_castsi256_si128  ( src    ) ) );
+            hi = _mm256_add_epi32( hi, _mm256_cvtepu16_epi32( _mm256_extracti128_si256( src, 1 ) ) );
+        }
+
+        __m256i *pDst = (__m256i*)(pDst_ + iPix);
+        const __m256i sum[4] =
+        {
+             _mm256_cvtepu32_epi64( _mm256_castsi256_si128  ( lo    ) )
+            ,_mm256_cvtepu32_epi64( _mm256_extracti128_si256( lo, 1 ) )
+            ,_mm256_cvtepu32_epi64( _mm256_castsi256_si128  ( hi    ) )
+            ,_mm256_cvtepu32_epi64( _mm256_extracti128_si256( hi, 1 ) )
+        };
+
+        for( int i = 0; i < 4; i++ )
+            _mm256_storeu_si256( pDst + i, _mm256_add_epi64( _mm256_loadu_si256( pDst + i ), sum[ i ] ) );
+    }
+
+    Gather_Scalar( aSrc, nSrc, pDst_, iPix, iEnd );
+}
+#endif
+// END SIMD
+
+
+// ========================================================================
+void Gather_Rows( const uint16_t * const *aSrc, const int nSrc, uint64_t *pDst, const int iRowBegin, const int iRowEnd )
+{
+// BEGIN SIMD
+#if SIMD_X86
+    static const bool bAVX2 = Escape_DetectEngine() >= ESCAPE_AVX2;
+    if( bAVX2 )
+        Gather_AVX2  ( aSrc, nSrc, pDst, iRowBegin * gnWidth, iRowEnd * gnWidth );
+    else
+#endif
+// END SIMD
+        Gather_Scalar( aSrc, nSrc, pDst, iRowBegin * gnWidth, iRowEnd * gnWidth );
+}
+
+
+// Each thread reduces a band of rows across all the copies
+// ========================================================================
+void Gather_Flat( const uint16_t * const *aSrc, const int nSrc )
+{
+#pragma omp parallel for schedule(static)
+    for( int iRow = 0; iRow < gnHeight; iRow++ )
+        Gather_Rows( aSrc, nSrc, gpCountTexels, iRow, iRow + 1 );
+}
+
+
+// Per-thread copies into the counts.
+// With the copies spread over several NUMA nodes each node's threads first
+// reduce their node's copies into a node-local partial; only the 64-bit
+// partials then cross the interconnect instead of every thread's copy.
+// That only pays with more than 4 (16-bit) copies per node. The first node
+// adds straight into the counts to save a partial.
+// ========================================================================
+void Gather_Copies()
+{
+    // Copies grouped by node
+    const uint16_t *aSrc[ MAX_THREADS ];
+    int             aRank[ MAX_THREADS ]; // thread's position within its node
+    int             aNodeOf[ MAX_THREADS ];
+    int             aNodeBegin[ MAX_NODES + 1 ];
+    int             aNodeId[ MAX_NODES ];
+    int             nNodes = 0;
+
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+    {
+        int iNode = 0;
+        while( (iNode < nNodes) && (aNodeId[ iNode ] != gaThreadsNode[ iThread ]) )
+            iNode++;
+        if( iNode == nNodes )
+            aNodeId[ nNodes++ ] = gaThreadsNode[ iThread ];
+        aNodeOf[ iThread ] = iNode;
+    }
+
+    int nSrc = 0;
+    for( int iNode = 0; iNode < nNodes; iNode++ )
+    {
+        aNodeBegin[ iNode ] = nSrc;
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+            if( aNodeOf[ iThread ] == iNode )
+            {
+                aRank[ iThread ] = nSrc - aNodeBegin[ iNode ];
+                aSrc[ nSrc++ ]   = gaThreadsTexels[ iThread ];
+            }
+    }
+    aNodeBegin[ nNodes ] = nSrc;
+
+    if( (nNodes <= 1) || (nSrc <= 4 * nNodes) )
+    {
+        Gather_Flat( aSrc, nSrc );
+        return;
+    }
+
+    uint64_t *aPartial[ MAX_NODES ];
+    aPartial[ 0 ] = gpCountTexels;
+    for( int iNode = 1; iNode < nNodes; iNode++ )
+        aPartial[ iNode ] = (uint64_t*) Image_Alloc( gnImageArea * sizeof( uint64_t ) );
+
+    // 1. Within each node: the node's threads split the rows, zeroing (first touch) then adding.
+    // Each thread takes its own copy's share of the rows, so a team smaller than
+    // asked for (OMP_DYNAMIC, a thread limit) would miss rows: then none start.
+    bool bShort = false;
+#pragma omp parallel num_threads( gnThreadsActive )
+    {
+        const int iTid = omp_get_thread_num();
+
+        if( omp_get_num_threads() != gnThreadsActive )
+        {
+            if( !iTid )
+                bShort = true;
+        }
+        else
+        {
+            const int iNode  = aNodeOf[ iTid ];
+            const int nCopy  = aNodeBegin[ iNode + 1 ] - aNodeBegin[ iNode ];
+            const int iBegin = (int)(((int64_t) aRank[ iTid ]      * gnHeight) / nCopy);
+            const int iEnd   = (int)(((int64_t)(aRank[ iTid ] + 1) * gnHeight) / nCopy);
+
+            if( iNode )
+                memset( aPartial[ iNode ] + (size_t)iBegin * gnWidth, 0, (size_t)(iEnd - iBegin) * gnWidth * sizeof( uint64_t ) );
+            Gather_Rows( aSrc + aNodeBegin[ iNode ], nCopy, aPartial[ iNode ], iBegin, iEnd );
+        }
+    }
+
+    if( bShort )
+    {
+        for( int iNode = 1; iNode < nNodes; iNode++ )
+            Image_Free( aPartial[ iNode ], gnImageArea * sizeof( uint64_t ) );
+
+        printf( "WARNING: Gather got fewer than %d threads, not reducing by node\n", gnThreadsActive );
+        Gather_Flat( aSrc, nSrc );
+        return;
+    }
+
+    // 2. Across nodes, in the same row bands the counts were first touched in
+#pragma omp parallel for schedule(static)
+    for( int iRow = 0; iRow < gnHeight; iRow++ )
+    {
+        uint64_t *pDst = gpCountTexels + (size_t)iRow * gnWidth;
+        for( int iNode = 1; iNode < nNodes; iNode++ )
+        {
+            const uint64_t *pSrc = aPartial[ iNode ] + (size_t)iRow * gnWidth;
+            for( int i = 0; i < gnWidth; i++ )
+                pDst[ i ] += pSrc[ i ];
+        }
+    }
+
+    for( int iNode = 1; iNode < nNodes; iNode++ )
+        Image_Free( aPartial[ iNode ], gnImageArea * sizeof( uint64_t ) );
+}
+
+
+// 8-bit copies and what is left in their overflow logs into the counts.
+// The compiler vectorises the 32-bit block sum; no NUMA grouping, the copies
+// are half the size of the 16-bit ones.
+// ========================================================================
+void Gather_Bytes()
+{
+    uint64_t nSpill = 0;
+
+#pragma omp parallel for schedule(static) reduction(+:nSpill)
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+    {
+        Bytes_Flush( gaThreadsBytes[ iThread ] );
+        nSpill += gaThreadsBytes[ iThread ].nSpill;
+    }
+
+    printf( "Overflow: %s 8-bit counters spilled\n", itoaComma( nSpill ) );
+
+    const int BLOCK = 64;
+    const int nPix  = (int) gnImageArea;
+
+#pragma omp parallel for schedule(static)
+    for( int iPix = 0; iPix < nPix; iPix += BLOCK )
+    {
+        const int n = (nPix - iPix < BLOCK) ? nPix - iPix : BLOCK;
+        uint32_t  aSum[ BLOCK ];
+
+        for( int i = 0; i < n; i++ )
+            aSum[ i ] = 0;
+
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+        {
+            const uint8_t *pSrc = gaThreadsBytes[ iThread ].texels + iPix;
+            for( int i = 0; i < n; i++ )
+                aSum[ i ] += pSrc[ i ];
+        }
+
+        for( int i = 0; i < n; i++ )
+            gpCountTexels[ iPix + i ] += aSum[ i ];
+    }
+}
+
+
+// Only the tiles some thread touched are read, one tile per task.
+// Threads that went dense are gathered like the copies first.
+// ========================================================================
+void Gather_Sparse()
+{
+    const int       size = 1 << gnBinTileShift;
+    int             nTouched = 0;
+    const uint16_t *aDense[ MAX_THREADS ];
+    int             nDense = 0;
+
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+        if( gaThreadsSparse[ iThread ].texels )
+            aDense[ nDense++ ] = gaThreadsSparse[ iThread ].texels;
+        else
+            nTouched += gaThreadsSparse[ iThread ].nTouched;
+
+    if( nDense )
+    {
+#pragma omp parallel for schedule(static)
+        for( int iRow = 0; iRow < gnHeight; iRow++ )
+            Gather_Rows( aDense, nDense, gpCountTexels, iRow, iRow + 1 );
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for( int iTile = 0; iTile < gnBinTiles; iTile++ )
+    {
+        const int u0 = (iTile % gnBinTilesX) << gnBinTileShift;
+        const int v0 = (iTile / gnBinTilesX) << gnBinTileShift;
+        const int nU = (gnWidth  - u0 < size) ? gnWidth  - u0 : size;
+        const int nV = (gnHeight - v0 < size) ? gnHeight - v0 : size;
+
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+        {
+            const uint16_t *tile = gaThreadsSparse[ iThread ].aTile[ iTile ];
+            if( !tile )
+                continue;
+
+            for( int v = 0; v < nV; v++ )
+            {
+                uint64_t       *pDst = gpCountTexels + (size_t)(v0 + v) * gnWidth + u0;
+                const uint16_t *pSrc = tile + (v << gnBinTileShift);
+                for( int u = 0; u < nU; u++ )
+                    pDst[ u ] += pSrc[ u ];
+            }
+        }
+    }
+
+    // A thread that went dense stopped counting at the quarter of the tiles that made it
+    const int nSparse = gnThreadsActive - nDense;
+    if( !nSparse )
+        printf( "Sparse: every thread went dense after touching %d of %d tiles, %u KB as dense copies\n"
+            , gaThreadsSparse[ 0 ].nTouched, gnBinTiles
+            , (unsigned)(((uint64_t) gnThreadsActive * gnImageArea * sizeof( uint16_t )) >> 10) );
+    else
+        printf( "Sparse: %d of %d tiles touched per sparse thread, %d of %d threads went dense, %u KB instead of %u KB\n"
+            , nTouched / nSparse, gnBinTiles
+            , nDense, gnThreadsActive
+            , (unsigned)((((uint64_t) nTouched << (2 * gnBinTileShift + 1)) + (uint64_t) nDense * gnImageArea * sizeof( uint16_t )) >> 10)
+            , (unsigned)(((uint64_t) gnThreadsActive * gnImageArea * sizeof( uint16_t )) >> 10) );
+}
+
+
+// Saturate the 64-bit counts into the 16-bit greyscale image used for the BMP
+// and the 16-bit raw, and find the brightest count.
+// The greyscale image is always row-major; -tiled# counts stay tiled until a wide raw needs them.
+// ========================================================================
+void Counts_Resolve()
+{
+    uint64_t nMax = 0;
+    uint64_t nSum = 0;
+
+// BEGIN OMP
+#pragma omp parallel for reduction(max:nMax) reduction(+:nSum)
+// END OMP
+    for( int v = 0; v < gnHeight; v++ )
+        for( int u = 0; u < gnWidth; u++ )
+        {
+            const uint64_t count = gpCountTexels[ Layout_Index( u, v, gnWidth, gnHeight ) ];
+            if( nMax < count )
+                nMax = count;
+            nSum += count;
+
+            gpGreyscaleTexels[ (v * gnWidth) + u ] = (count < 0xFFFF) ? (uint16_t) count : 0xFFFF;
+        }
+
+    gnMaxCount = nMax;
+    gnDeposits = nSum;
+}
+
+
+// Hand the calling thread its next range of seeds [iBegin,iEnd) out of the epoch's [iSeedBegin,iSeedEnd)
+// @return false when there are none left
+// ========================================================================
+bool Schedule_Next( const size_t iSeedBegin, const size_t iSeedEnd, const int iTid, size_t *iBegin_, size_t *iEnd_ )
+{
+    ThreadSchedule &schedule = gaThreadsSchedule[ iTid ];
+    const size_t    nThreads = gnThreadsActive;
+    const size_t    nSeeds   = iSeedEnd - iSeedBegin;
+
+    if( gnSchedule == SCHEDULE_STATIC )
+    {
+        if( schedule.nEpoch == gnScheduleEpoch )
+            return false;
+        schedule.nEpoch = gnScheduleEpoch;
+
+        *iBegin_ = iSeedBegin + (nSeeds *  iTid     ) / nThreads;
+        *iEnd_   = iSeedBegin + (nSeeds * (iTid + 1)) / nThreads;
+        return *iBegin_ < *iEnd_;
+    }
+
+    const size_t nNext = gnScheduleNext.load( std::memory_order_relaxed );
+    const size_t nLeft = (nNext < iSeedEnd) ? iSeedEnd - nNext : 0;
+    /* */ size_t nRange;
+
+    if( gnSchedule == SCHEDULE_GUIDED )
+        nRange = nLeft / nThreads;
+    else
+    {
+        // Aim for SCHEDULE_SECONDS at the last range's cost, but at most double the
+        // last range (the next seeds may be far more expensive) and leave enough
+        // for the other threads to finish together
+        nRange = schedule.nCost > 0. ? (size_t)(SCHEDULE_SECONDS / schedule.nCost) : SCHEDULE_MIN;
+        if( schedule.nRange && (nRange > 2 * schedule.nRange) )
+            nRange = 2 * schedule.nRange;
+        if( nRange > nLeft / (2 * nThreads) )
+            nRange = nLeft / (2 * nThreads);
+    }
+
+    if( nRange < SCHEDULE_MIN )
+        nRange = SCHEDULE_MIN;
+
+    const size_t iBegin = gnScheduleNext.fetch_add( nRange, std::memory_order_relaxed );
+    if( iBegin >= iSeedEnd )
+        return false;
+
+    *iBegin_ = iBegin;
+    *iEnd_   = (iBegin + nRange < iSeedEnd) ? iBegin + nRange : iSeedEnd;
+    return true;
+}
+
+
+// ========================================================================
+void Schedule_Done( const int iTid, const size_t nSeeds, const double nStart, const double nStop )
+{
+    ThreadSchedule &schedule = gaThreadsSchedule[ iTid ];
+    const double    nSeconds = nStop - nStart;
+
+    if( (size_t)schedule.nRanges == gnThreadsRangesMax[ iTid ] )
+    {
+        gnThreadsRangesMax[ iTid ] = gnThreadsRangesMax[ iTid ] ? 2*gnThreadsRangesMax[ iTid ] : 1024;
+        gaThreadsRanges   [ iTid ] = (double*) realloc( gaThreadsRanges[ iTid ], 2 * gnThreadsRangesMax[ iTid ] * sizeof( double ) );
+    }
+
+    gaThreadsRanges[ iTid ][ 2*schedule.nRanges + 0 ] = nStart;
+    gaThreadsRanges[ iTid ][ 2*schedule.nRanges + 1 ] = nStop;
+
+    schedule.nBusy += nSeconds;
+    schedule.nCost  = nSeconds / nSeeds;
+    schedule.nRange = nSeeds;
+    schedule.nRanges++;
+}
+
+
+// Per-thread busy and idle time of the scatter that started at nBegin
+// ========================================================================
+void Schedule_Report( const double nBegin )
+{
+    double nWall = 0., nBusy = 0.;
+    int    nRanges = 0;
+
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+    {
+        const ThreadSchedule &schedule = gaThreadsSchedule[ iThread ];
+        if( nWall < schedule.nEnd - nBegin )
+            nWall = schedule.nEnd - nBegin;
+        nBusy   += schedule.nBusy;
+        nRanges += schedule.nRanges;
+    }
+
+    // Time the threads spent iterating ranges over the last 10% of the wall time,
+    // when the stragglers finish; waiting for seeds or other threads doesn't count
+    const double nTailBegin = nBegin + 0.9 * nWall;
+    const double nTailEnd   = nBegin +       nWall;
+    /* */ double nTail      = 0.;
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+        for( int iRange = 0; iRange < gaThreadsSchedule[ iThread ].nRanges; iRange++ )
+        {
+            const double nStart = gaThreadsRanges[ iThread ][ 2*iRange + 0 ];
+            const double nStop  = gaThreadsRanges[ iThread ][ 2*iRange + 1 ];
+            const double nFrom  = (nStart > nTailBegin) ? nStart : nTailBegin;
+            const double nTo    = (nStop  < nTailEnd  ) ? nStop  : nTailEnd;
+            if( nTo > nFrom )
+                nTail += nTo - nFrom;
+        }
+
+    printf( "Schedule: %s, %d ranges, %.1f%% busy over %.3f s, %.1f%% in the last 10%%\n"
+        , gaScheduleName[ gnSchedule ], nRanges, nWall > 0. ? (100.0 * nBusy) / (nWall * gnThreadsActive) : 100., nWall
+        , nWall > 0. ? (100.0 * nTail) / ((nTailEnd - nTailBegin) * gnThreadsActive) : 100. );
+
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+    {
+        const ThreadSchedule &schedule = gaThreadsSchedule[ iThread ];
+        printf( "    #%-3d busy %8.3f s  idle %8.3f s  %6d ranges\n"
+            , iThread, schedule.nBusy, nWall - schedule.nBusy, schedule.nRanges );
+    }
+}
+
+
+// Quick escape pass: COST_SAMPLES seeds evenly across the middle row of each band
+// ========================================================================
+void Cost_Estimate( const SeedSource &seeds, const size_t nRow, const int nBands )
+{
+// BEGIN OMP
+#pragma omp parallel for schedule(dynamic)
+// END OMP
+    for( int iBand = 0; iBand < nBands; iBand++ )
+    {
+        const size_t iMiddle = (size_t)iBand * gnScale + gnScale / 2;
+        const size_t iRow    = (iMiddle < nRow) ? iMiddle : nRow - 1;
+        const double y       = gnDomainMinY + (iRow * seeds.dy);
+
+        double nCost = 0.;
+        for( int iSample = 0; iSample < COST_SAMPLES; iSample++ )
+        {
+            const size_t iCol = ((2 * iSample + 1) * seeds.nCol) / (2 * COST_SAMPLES);
+            const double x    = gnDomainMinX + (iCol * seeds.dx);
+
+            if( gbCullInterior && Interior( x, y ) )
+            {
+                nCost += 1.;
+                continue;
+            }
+
+            // An escaping seed is iterated twice: escape test, then plot()
+            const int depth = Adaptive_EscapeDepth( x, y );
+            nCost += (depth < gnMaxDepth) ? 2.0 * (depth + 1) : gnMaxDepth;
+        }
+
+        gaCostBand[ iBand ] = nCost;
+    }
+}
+
+
+// ========================================================================
+void Cost_Header( CostMapHeader *header_, const int nBands )
+{
+    memset( header_, 0, sizeof( CostMapHeader ) );
+    memcpy( header_->magic, COSTMAP_MAGIC, sizeof( header_->magic ) );
+    header_->width     = gnWidth;
+    header_->height    = gnHeight;
+    header_->scale     = gnScale;
+    header_->depth     = gnMaxDepth;
+    header_->symmetry  = gbSymmetry;
+    header_->bands     = nBands;
+    header_->world [0] = gnWorldMinX ; header_->world [1] = gnWorldMaxX ; header_->world [2] = gnWorldMinY ; header_->world [3] = gnWorldMaxY ;
+    header_->domain[0] = gnDomainMinX; header_->domain[1] = gnDomainMaxX; header_->domain[2] = gnDomainMinY; header_->domain[3] = gnDomainMaxY;
+}
+
+
+// Cost per band measured by an earlier run of the same render
+// @return false if the file is missing or is for a different render
+// ========================================================================
+bool Cost_Load( const char *filename, const int nBands )
+{
+    FILE *file = fopen( filename, "rb" );
+    if( !file )
+        return false;
+
+    CostMapHeader expect, header;
+    Cost_Header( &expect, nBands );
+
+    const bool bRead = (fread( &header, sizeof( header ), 1, file ) == 1)
+                    && (memcmp( &header, &expect, sizeof( header ) ) == 0)
+                    && (fread( gaCostBand, sizeof( double ), nBands, file ) == (size_t)nBands);
+    fclose( file );
+
+    if( !bRead )
+        printf( "WARNING: Cost map %s is for a different render, estimating instead\n", filename );
+    return bRead;
+}
+
+
+// @return false if the file couldn't be written
+// ========================================================================
+bool Cost_Save( const char *filename, const int nBands )
+{
+    CostMapHeader header;
+    Cost_Header( &header, nBands );
+
+    bool  bSaved = false;
+    FILE *file   = fopen( filename, "wb" );
+    if( file )
+    {
+        bSaved = (fwrite( &header, sizeof( header ), 1, file ) == 1)
+              && (fwrite( gaCostMeasured, sizeof( double ), nBands, file ) == (size_t)nBands);
+        fclose( file );
+    }
+    return bSaved;
+}
+
+
+// Descending cost, ties in grid order
+// ========================================================================
+int Work_CompareCost( const void *a, const void *b )
+{
+    const WorkItem *pA = (const WorkItem*) a;
+    const WorkItem *pB = (const WorkItem*) b;
+
+    const double nCostA = gaCostBand[ pA->band ];
+    const double nCostB = gaCostBand[ pB->band ];
+
+    if( nCostA != nCostB ) return (nCostA < nCostB) - (nCostA > nCostB);
+    return (pA->iBegin > pB->iBegin) - (pA->iBegin < pB->iBegin);
+}
+
+
+// FNV-1a over 64-bit words; every part of a record is a multiple of 8 bytes
+// ========================================================================
+uint64_t Checkpoint_Hash( uint64_t hash, const void *data, const size_t nBytes )
+{
+    const uint64_t *pWord = (const uint64_t*) data;
+    for( size_t iWord = 0; iWord < nBytes / sizeof( uint64_t ); iWord++ )
+    {
+        hash ^= pWord[ iWord ];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+
+// ========================================================================
+uint64_t Checkpoint_Blocks()
+{
+    return ((uint64_t) gnImageArea + (1 << CHECKPOINT_BLOCK_SHIFT) - 1) >> CHECKPOINT_BLOCK_SHIFT;
+}
+
+
+// Counts in the block; the last one may be partial
+// ========================================================================
+uint64_t Checkpoint_BlockCounts( const uint64_t iBlock )
+{
+    const uint64_t iBegin = iBlock << CHECKPOINT_BLOCK_SHIFT;
+    const uint64_t iEnd   = iBegin + (1 << CHECKPOINT_BLOCK_SHIFT);
+    return ((iEnd < gnImageArea) ? iEnd : gnImageArea) - iBegin;
+}
+
+
+// Done bitmap rounded up to whole words for the hash
+// ========================================================================
+size_t Checkpoint_BitmapBytes()
+{
+    return (size_t)((gnCheckpointItems + 63) / 64) * sizeof( uint64_t );
+}
+
+
+// ========================================================================
+void Checkpoint_Header( CheckpointHeader *header_ )
+{
+    memset( header_, 0, sizeof( CheckpointHeader ) );
+    memcpy( header_->magic, CHECKPOINT_MAGIC, sizeof( header_->magic ) );
+    header_->width     = gnWidth;
+    header_->height    = gnHeight;
+    header_->scale     = gnScale;
+    header_->depth     = gnMaxDepth;
+    header_->source    = gnSeedSource;
+    header_->symmetry  = gbSymmetry;
+    header_->layout    = gnLayoutShift;
+    header_->adaptive  = gnAdaptiveStride;
+    header_->period    = gbPeriodic ? gnPeriodExponent : 0;
+    header_->key       = gnRandomKey;
+    header_->samples   = gnSamples;
+    header_->world [0] = gnWorldMinX ; header_->world [1] = gnWorldMaxX ; header_->world [2] = gnWorldMinY ; header_->world [3] = gnWorldMaxY ;
+    header_->domain[0] = gnDomainMinX; header_->domain[1] = gnDomainMaxX; header_->domain[2] = gnDomainMinY; header_->domain[3] = gnDomainMaxY;
+    header_->work      = gnCheckpointItems;
+}
+
+
+// Move the per-thread copies into the counts, marking the blocks they change
+// ========================================================================
+void Checkpoint_Gather()
+{
+    const int nBlocks = (int) Checkpoint_Blocks();
+
+// BEGIN OMP
+#pragma omp parallel for schedule(static)
+// END OMP
+    for( int iBlock = 0; iBlock < nBlocks; iBlock++ )
+    {
+        const int iBegin = iBlock << CHECKPOINT_BLOCK_SHIFT;
+        const int iEnd   = iBegin + (int) Checkpoint_BlockCounts( iBlock );
+        /* */ bool bDirty = false;
+
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+        {
+            uint16_t *pSrc = gaThreadsTexels[ iThread ];
+            for( int iTexel = iBegin; iTexel < iEnd; iTexel++ )
+                if( pSrc[ iTexel ] )
+                {
+                    gpCountTexels[ iTexel ] += pSrc[ iTexel ];
+                    pSrc[ iTexel ] = 0;
+                    bDirty = true;
+                }
+        }
+
+        if( bDirty )
+            gaCheckpointDirty[ iBlock ] = 1;
+    }
+}
+
+
+// Bytes a record of nBlocks full blocks takes
+// ========================================================================
+uint64_t Checkpoint_RecordBytes( const uint64_t nBlocks )
+{
+    return sizeof( CheckpointRecord ) + Checkpoint_BitmapBytes()
+         + nBlocks * (sizeof( uint64_t ) + (sizeof( uint64_t ) << CHECKPOINT_BLOCK_SHIFT))
+         + sizeof( uint64_t );
+}
+
+
+// Append the done bitmap and every block (bAll) or the dirty ones
+// @return bytes written, 0 on error
+// ========================================================================
+uint64_t Checkpoint_WriteRecord( FILE *file, const bool bAll )
+{
+    const uint64_t nBlocks = Checkpoint_Blocks();
+    const size_t   nBitmap = Checkpoint_BitmapBytes();
+
+    CheckpointRecord record;
+    memset( &record, 0, sizeof( record ) );
+    memcpy( record.magic, CHECKPOINT_RECORD, sizeof( record.magic ) );
+    record.bytes = sizeof( record ) + nBitmap + sizeof( uint64_t );
+
+    for( uint64_t iBlock = 0; iBlock < nBlocks; iBlock++ )
+        if( bAll || gaCheckpointDirty[ iBlock ] )
+        {
+            record.blocks++;
+            record.bytes += sizeof( uint64_t ) + Checkpoint_BlockCounts( iBlock ) * sizeof( uint64_t );
+        }
+
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    hash = Checkpoint_Hash( hash, &record, sizeof( record ) );
+    hash = Checkpoint_Hash( hash, gaCheckpointDone, nBitmap );
+
+    bool bWrite = (fwrite( &record, sizeof( record ), 1, file ) == 1)
+               && (fwrite( gaCheckpointDone, 1, nBitmap, file ) == nBitmap);
+
+    for( uint64_t iBlock = 0; (iBlock < nBlocks) && bWrite; iBlock++ )
+        if( bAll || gaCheckpointDirty[ iBlock ] )
+        {
+            const uint64_t *pCounts = gpCountTexels + (iBlock << CHECKPOINT_BLOCK_SHIFT);
+            const size_t    nCounts = (size_t) Checkpoint_BlockCounts( iBlock );
+
+            hash = Checkpoint_Hash( hash, &iBlock, sizeof( iBlock ) );
+            hash = Checkpoint_Hash( hash, pCounts, nCounts * sizeof( uint64_t ) );
+
+            bWrite = (fwrite( &iBlock, sizeof( iBlock ), 1, file ) == 1)
+                  && (fwrite( pCounts, sizeof( uint64_t ), nCounts, file ) == nCounts);
+        }
+
+    bWrite = bWrite && (fwrite( &hash, sizeof( hash ), 1, file ) == 1);
+    return bWrite ? record.bytes : 0;
+}
+
+
+// Make sure the record is on disk before the file is used
+// @return false if any of it couldn't be written
+// ========================================================================
+bool Checkpoint_Close( FILE *file )
+{
+    bool bClosed = fflush( file ) == 0;
+#if !_WIN32
+    bClosed = bClosed && (fsync( fileno( file ) ) == 0);
+#endif
+    return (fclose( file ) == 0) && bClosed;
+}
+
+
+// Merge the copies, then append the dirty blocks. The first checkpoint, and any
+// whose records would make the file twice the size of a snapshot, writes a
+// snapshot to foo.tmp and renames it over foo so the old file stays valid until
+// the new one is complete.
+// ========================================================================
+void Checkpoint_Save()
+{
+    const double nStart = omp_get_wtime();
+
+    Checkpoint_Gather();
+
+    const uint64_t nBlocks = Checkpoint_Blocks();
+    /* */ uint64_t nDirty  = 0;
+    for( uint64_t iBlock = 0; iBlock < nBlocks; iBlock++ )
+        nDirty += gaCheckpointDirty[ iBlock ];
+
+    const uint64_t nSnapshot = sizeof( CheckpointHeader ) + Checkpoint_RecordBytes( nBlocks );
+    const bool     bSnapshot = !gnCheckpointBytes || (gnCheckpointBytes + Checkpoint_RecordBytes( nDirty ) > 2 * nSnapshot);
+    /* */ uint64_t nWritten  = 0;
+
+    if( bSnapshot )
+    {
+        const int PATH_SIZE = 256;
+        char filenameTemp[ PATH_SIZE ];
+        snprintf( filenameTemp, PATH_SIZE, "%s.tmp", gpFileNameCheckpoint );
+
+        CheckpointHeader header;
+        Checkpoint_Header( &header );
+
+        FILE *file = fopen( filenameTemp, "wb" );
+        if( file )
+        {
+            nWritten = (fwrite( &header, sizeof( header ), 1, file ) == 1) ? Checkpoint_WriteRecord( file, true ) : 0;
+            if( !Checkpoint_Close( file ) )
+                nWritten = 0;
+        }
+
+#if _WIN32
+        if( nWritten )
+            remove( gpFileNameCheckpoint ); // rename() won't replace an existing file
+#endif
+        if( nWritten && (rename( filenameTemp, gpFileNameCheckpoint ) == 0) )
+            gnCheckpointBytes = sizeof( header ) + nWritten;
+        else
+            nWritten = 0;
+    }
+    else
+    {
+        FILE *file = fopen( gpFileNameCheckpoint, "r+b" );
+        if( file )
+        {
+            nWritten = (fseek( file, (long) gnCheckpointBytes, SEEK_SET ) == 0) ? Checkpoint_WriteRecord( file, false ) : 0;
+            if( !Checkpoint_Close( file ) )
+                nWritten = 0;
+        }
+
+        if( nWritten )
+            gnCheckpointBytes += nWritten;
+    }
+
+    const double nElapsed = omp_get_wtime() - nStart;
+
+    if( !nWritten )
+    {
+        // Keep the dirty blocks for the next try
+        printf( "ERROR: Couldn't save checkpoint: %s\n", gpFileNameCheckpoint );
+        gnCheckpointSeconds += nElapsed;
+        return;
+    }
+
+    memset( gaCheckpointDirty, 0, (size_t) nBlocks );
+
+    uint64_t nDone = 0;
+    for( uint64_t iWork = 0; iWork < gnCheckpointItems; iWork++ )
+        nDone += (gaCheckpointDone[ iWork >> 3 ] >> (iWork & 7)) & 1;
+
+    printf( "Checkpoint: %llu / %llu work items, %s %llu / %llu blocks, %.1f MB in %.3f s\n"
+        , (unsigned long long) nDone, (unsigned long long) gnCheckpointItems
+        , bSnapshot ? "snapshot" : "changed"
+        , (unsigned long long)(bSnapshot ? nBlocks : nDirty), (unsigned long long) nBlocks
+        , nWritten / (1024. * 1024.), nElapsed );
+
+    gnCheckpoints++;
+    gnCheckpointSeconds += nElapsed;
+}
+
+
+// Restore the settings of the render that wrote the checkpoint
+// @return false if the file is missing or isn't a checkpoint
+// ========================================================================
+bool Checkpoint_LoadHeader( const char *filename )
+{
+    FILE *file = fopen( filename, "rb" );
+    if( !file )
+        return false;
+
+    CheckpointHeader header;
+    const bool bRead = (fread( &header, sizeof( header ), 1, file ) == 1)
+                    && (memcmp( header.magic, CHECKPOINT_MAGIC, sizeof( header.magic ) ) == 0);
+    fclose( file );
+
+    if( !bRead )
+        return false;
+
+    gnWidth          = header.width;
+    gnHeight         = header.height;
+    gnScale          = header.scale;
+    gnMaxDepth       = header.depth;
+    gnSeedSource     = header.source;
+    gbSymmetry       = header.symmetry != 0;
+    gnLayoutShift    = header.layout;
+    gnAdaptiveStride = header.adaptive;
+    gbPeriodic       = header.period != 0;
+    if( gbPeriodic )
+        gnPeriodExponent = header.period;
+    gnRandomKey      = header.key;
+    gnSamples        = header.samples;
+    gnWorldMinX      = header.world [0]; gnWorldMaxX  = header.world [1]; gnWorldMinY  = header.world [2]; gnWorldMaxY  = header.world [3];
+    gnDomainMinX     = header.domain[0]; gnDomainMaxX = header.domain[1]; gnDomainMinY = header.domain[2]; gnDomainMaxY = header.domain[3];
+    gbDomain         = true;
+
+    gnCheckpointItems = header.work;
+    gaCheckpointDone  = (uint8_t*) calloc( Checkpoint_BitmapBytes(), 1 );
+    return true;
+}
+
+
+// Apply every complete record; a torn or corrupt one ends the state.
+// Needs the counts allocated, see Checkpoint_LoadHeader().
+// @return false if there is no complete record
+// ========================================================================
+bool Checkpoint_LoadState( const char *filename )
+{
+    FILE *file = fopen( filename, "rb" );
+    if( !file )
+        return false;
+
+    fseek( file, 0, SEEK_END );
+    const uint64_t nFile = (uint64_t) ftell( file );
+    fseek( file, sizeof( CheckpointHeader ), SEEK_SET );
+
+    const uint64_t nBlocks = Checkpoint_Blocks();
+    const size_t   nBitmap = Checkpoint_BitmapBytes();
+    /* */ uint64_t nValid  = 0; // end of the last complete record
+    /* */ uint64_t nOffset = sizeof( CheckpointHeader );
+    /* */ int      nRecords = 0;
+    /* */ uint8_t *pBuffer = NULL;
+
+    CheckpointRecord record;
+    while( (fread( &record, sizeof( record ), 1, file ) == 1)
+        && (memcmp( record.magic, CHECKPOINT_RECORD, sizeof( record.magic ) ) == 0)
+        && (record.bytes >= sizeof( record ) + nBitmap + sizeof( uint64_t ))
+        && (record.bytes <= nFile - nOffset) )
+    {
+        const size_t nPayload = (size_t)(record.bytes - sizeof( record ));
+        pBuffer = (uint8_t*) realloc( pBuffer, nPayload );
+        if( fread( pBuffer, 1, nPayload, file ) != nPayload )
+            break;
+
+        uint64_t hash, expect;
+        memcpy( &expect, pBuffer + nPayload - sizeof( uint64_t ), sizeof( expect ) );
+        hash = Checkpoint_Hash( 0xCBF29CE484222325ULL, &record, sizeof( record ) );
+        hash = Checkpoint_Hash( hash, pBuffer, nPayload - sizeof( uint64_t ) );
+        if( hash != expect )
+            break;
+
+        // Check the block list fits before touching the counts
+        const uint8_t *pBlock = pBuffer + nBitmap;
+        /* */ bool     bValid = true;
+        for( uint64_t iRecord = 0; (iRecord < record.blocks) && bValid; iRecord++ )
+        {
+            uint64_t iBlock;
+            memcpy( &iBlock, pBlock, sizeof( iBlock ) );
+            bValid  = (iBlock < nBlocks);
+            pBlock += bValid ? sizeof( uint64_t ) + Checkpoint_BlockCounts( iBlock ) * sizeof( uint64_t ) : 0;
+            bValid  = bValid && (pBlock <= pBuffer + nPayload - sizeof( uint64_t ));
+        }
+        if( !bValid )
+            break;
+
+        memcpy( gaCheckpointDone, pBuffer, nBitmap );
+
+        pBlock = pBuffer + nBitmap;
+        for( uint64_t iRecord = 0; iRecord < record.blocks; iRecord++ )
+        {
+            uint64_t iBlock;
+            memcpy( &iBlock, pBlock, sizeof( iBlock ) );
+
+            const size_t nCounts = (size_t) Checkpoint_BlockCounts( iBlock );
+            memcpy( gpCountTexels + (iBlock << CHECKPOINT_BLOCK_SHIFT), pBlock + sizeof( uint64_t ), nCounts * sizeof( uint64_t ) );
+            pBlock += sizeof( uint64_t ) + nCounts * sizeof( uint64_t );
+        }
+
+        nOffset += record.bytes;
+        nValid   = nOffset;
+        nRecords++;
+    }
+
+    free( pBuffer );
+    fclose( file );
+
+    if( !nRecords )
+        return false;
+
+    // A torn record at the end is left for the next snapshot to replace
+    gnCheckpointBytes = (nValid == nFile) ? nValid : 0;
+    if( nValid != nFile )
+        printf( "WARNING: Checkpoint %s has %llu bytes after the last complete record, ignored\n", filename, (unsigned long long)(nFile - nValid) );
+
+    printf( "Resume: %d checkpoint record%s from %s\n", nRecords, (nRecords == 1) ? "" : "s", filename );
+    return true;
+}
+
+
+// Where the next epoch should end so it finishes about when the checkpoint is due.
+// The first epoch is a short probe to measure the rate.
+// @param aFirst seeds before each work item
+// ========================================================================
+int Checkpoint_EpochEnd( const size_t *aFirst, const int nWork, const int iWorkBegin, const double nScatter, const double nCheckpoint )
+{
+    const double nNow     = omp_get_wtime();
+    const double nElapsed = nNow - nScatter - gnCheckpointSeconds;
+    const size_t nDone    = aFirst[ iWorkBegin ];
+
+    size_t nTarget;
+    if( !nDone || (nElapsed <= 0.) )
+        nTarget = aFirst[ nWork ] / 100;
+    else
+        nTarget = nDone + (size_t)((nDone / nElapsed) * (nCheckpoint - nNow));
+
+    int iWorkEnd = (int)(std::lower_bound( aFirst + iWorkBegin + 1, aFirst + nWork + 1, nTarget ) - aFirst);
+    if( iWorkEnd > nWork )
+        iWorkEnd = nWork;
+    return iWorkEnd;
+}
+
+
+// Iterate the seeds [iSeedBegin,iSeedEnd) of the work list
+// @param aFirst seeds before each work item
+// ========================================================================
+void Scatter( const SeedSource &seeds, const WorkItem *aWork, const size_t *aFirst, const int nWork, const size_t iSeedBegin, const size_t iSeedEnd, const double sx, const double sy )
+{
+    gnOwnersDone   = 0;
+    gnScheduleNext = iSeedBegin;
+    gnScheduleEpoch++;
+
+// BEGIN OMP
+#pragma omp parallel num_threads( gnThreadsActive )
+    {
+        const int iTid = omp_get_thread_num(); // Get Thread Index: 0 .. nCores-1
+// END OMP
+
+        gpStaging = &gaThreadsStaging[ iTid ];
+        gpStripe  =  gaAtomicStripes [ iTid % gnAtomicStripes ];
+        gpBytes   = &gaThreadsBytes  [ iTid ];
+        gpSparse  = &gaThreadsSparse [ iTid ];
+
+        size_t iBegin, iEnd;
+        while( Schedule_Next( iSeedBegin, iSeedEnd, iTid, &iBegin, &iEnd ) )
+        {
+            const double nStart = omp_get_wtime();
+            int          iWork  = (int)(std::upper_bound( aFirst, aFirst + nWork + 1, iBegin ) - aFirst) - 1;
+
+            for( size_t iSeed = iBegin; iSeed < iEnd; iWork++ )
+            {
+                const WorkItem &work  = aWork[ iWork ];
+                const size_t    iLast = (iEnd < aFirst[ iWork + 1 ]) ? iEnd : aFirst[ iWork + 1 ];
+                /* */ SeedSource item = seeds;
+
+                if( gnSeedSource == SEED_ADAPTIVE )
+                {
+                    item.col0   = work.col0;
+                    item.row0   = work.row0;
+                    item.nRun   = work.nRun;
+                    item.stride = work.stride;
+                }
+
+                if( (gnSeedSource == SEED_ADAPTIVE) || (gnSeedSource == SEED_RESUME) )
+                    item.weight = work.weight;
+
+                const size_t iFirst = work.iBegin + (iSeed - aFirst[ iWork ]);
+                const size_t iStop  = work.iBegin + (iLast - aFirst[ iWork ]);
+                const double nItem  = gaCostMeasured ? omp_get_wtime() : 0.;
+
+                // Tile ownership: other producers' batches sit in our inbox until we apply them
+                const size_t nChunk = (gnAccumulate == ACCUMULATE_OWNER) ? OWNER_DRAIN_SEEDS : iStop - iFirst;
+
+                for( size_t iChunk = iFirst; iChunk < iStop; iChunk += nChunk )
+                {
+                    const size_t iChunkEnd = (iChunk + nChunk < iStop) ? iChunk + nChunk : iStop;
+
+                    switch( gnEscapeEngine )
+                    {
+// BEGIN SIMD
+#if SIMD_X86
+                        case ESCAPE_AVX512: Escape_AVX512( item, iChunk, iChunkEnd, sx, sy, iTid, work.mirror ); break;
+                        case ESCAPE_AVX2  : Escape_AVX2  ( item, iChunk, iChunkEnd, sx, sy, iTid, work.mirror ); break;
+#endif
+// END SIMD
+                        default           : Escape_Scalar( item, iChunk, iChunkEnd, sx, sy, iTid, work.mirror ); break;
+                    }
+
+                    if( gnAccumulate == ACCUMULATE_OWNER )
+                        Owner_Drain( iTid );
+                }
+
+                if( gaCostMeasured )
+                {
+// BEGIN OMP
+#pragma omp atomic
+// END OMP
+                    gaCostMeasured[ work.band ] += omp_get_wtime() - nItem;
+                }
+
+                Progress_Add( iTid, (iStop - iFirst) * (work.mirror ? 2 : 1) * item.weight );
+                iSeed = iLast;
+            }
+
+            Schedule_Done( iTid, iEnd - iBegin, nStart, omp_get_wtime() );
+        }
+
+        gaThreadsSchedule[ iTid ].nEnd = omp_get_wtime();
+
+// BEGIN OMP
+        // Tile ownership: ship what is left, then keep applying parcels until every thread has
+        if( gnAccumulate == ACCUMULATE_OWNER )
+        {
+            Owner_Ship( gaThreadsStaging[ iTid ] );
+            gnOwnersDone++;
+
+            while( gnOwnersDone < gnThreadsActive )
+            {
+                Owner_Drain( iTid );
+                std::this_thread::yield(); // let the producers still working have the core
+            }
+            Owner_Drain( iTid );
+        }
+    }
+// END OMP
+}
+
+
+// @return Number of seeds (Not uber total of all pixels processed)
+// ========================================================================
+uint64_t Buddhabrot()
+{
+    if( gnScale < 0)
+        gnScale = 1;
+
+    const size_t nCol = gnWidth  * gnScale ; // scaled width
+    const size_t nRow = gnHeight * gnScale ; // scaled height
+
+    /* */ size_t nCel = nCol     * nRow    ; // scaled width  * scaled height;
+
+    const double nWorldW = gnWorldMaxX - gnWorldMinX;
+    const double nWorldH = gnWorldMaxY - gnWorldMinY;
+
+    const double nDomainW = gnDomainMaxX - gnDomainMinX;
+    const double nDomainH = gnDomainMaxY - gnDomainMinY;
+
+    // Map Source (world space) to Pixels (image space)
+    const double nWorld2ImageX = (double)(gnWidth  - 1.) / nWorldW;
+    const double nWorld2ImageY = (double)(gnHeight - 1.) / nWorldH;
+
+    SeedSource seeds;
+    seeds.type = gnSeedSource;
+    seeds.nCol = nCol;
+    seeds.dx   = nDomainW / (nCol - 1.0);
+    seeds.dy   = nDomainH / (nRow - 1.0);
+    seeds.key  = gnRandomKey;
+    seeds.minY = gnDomainMinY;
+    seeds.w    = nDomainW;
+    seeds.h    = nDomainH;
+    seeds.weight = 1;
+    seeds.aPending = gaPending;
+    seeds.base     = gnPendingSource;
+
+    const Philox4x32 shift = Philox( ~0ULL, gnRandomKey );
+    seeds.shiftU = ((uint64_t)shift.v[0] << 32) | shift.v[1];
+    seeds.shiftV = ((uint64_t)shift.v[2] << 32) | shift.v[3];
+
+    if( gnSeedSource == SEED_METROPOLIS )
+    {
+        if( gnSamples )
+            nCel = gnSamples;
+
+        if( gbSymmetry )
+            printf( "Symmetry: OFF, not used by Metropolis sampling\n" );
+        if( gnAccumulate != ACCUMULATE_COPIES )
+            printf( "Accumulate: %s not used by Metropolis sampling\n", gaAccumulateName[ gnAccumulate ] );
+
+        // One independent chain per thread
+        const int nChains = gnThreadsActive;
+        Progress_Start( nCel, gnThreadsActive, gbVerbose );
+
+// BEGIN OMP
+#pragma omp parallel for schedule(static,1)
+// END OMP
+        for( int iChain = 0; iChain < nChains; iChain++ )
+        {
+// BEGIN OMP
+            const int      iTid   = omp_get_thread_num(); // Get Thread Index: 0 .. nCores-1
+// END OMP
+            const uint64_t nSteps = (nCel / nChains) + ((uint64_t)iChain < (nCel % nChains) ? 1 : 0);
+
+            Metropolis_Chain( iChain, nSteps, nWorld2ImageX, nWorld2ImageY, iTid );
+        }
+
+        Progress_Stop();
+        Metropolis_Gather( nCel );
+        Counts_Resolve();
+        return nCel;
+    }
+
+    /* */ WorkItem *aWork = NULL;
+    /* */ int       nWork = 0;
+
+    // With symmetry random and Sobol samples come from the upper half and are mirrored
+    const int  nSource = (gnSeedSource == SEED_RESUME) ? gnPendingSource : gnSeedSource;
+    const bool bHalf   = ((nSource == SEED_RANDOM) || (nSource == SEED_SOBOL))
+                      && gbSymmetry && (fabs( gnDomainMinY + gnDomainMaxY ) <= 1e-9 * nDomainH);
+    if( bHalf )
+    {
+        seeds.minY = 0.;
+        seeds.h    = gnDomainMaxY;
+    }
+
+    if( gnSeedSource == SEED_RESUME )
+    {
+        // Blocks of pending seeds with the same weight and mirror; 1st pass counts them
+        const size_t nBlock = 4096;
+        nCel = 0;
+
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            if( iPass )
+                aWork = (WorkItem*) malloc( (nWork ? nWork : 1) * sizeof( WorkItem ) );
+            nWork = 0;
+
+            for( size_t iBegin = 0; iBegin < gnPending; )
+            {
+                const PendingSeed &first = gaPending[ iBegin ];
+
+                size_t iEnd = iBegin + 1;
+                while( (iEnd < gnPending) && (iEnd - iBegin < nBlock)
+                    && (gaPending[ iEnd ].weight == first.weight) && (gaPending[ iEnd ].mirror == first.mirror) )
+                    iEnd++;
+
+                if( iPass )
+                {
+                    WorkItem &work = aWork[ nWork ];
+                    work.iBegin = iBegin;
+                    work.iEnd   = iEnd;
+                    work.mirror = first.mirror != 0;
+                    work.weight = first.weight;
+
+                    nCel += (iEnd - iBegin) * (work.mirror ? 2 : 1) * work.weight;
+                }
+
+                nWork++;
+                iBegin = iEnd;
+            }
+        }
+
+        printf( "Resume: %s seeds from depth %d\n", itoaComma( gnPending ), gnPendingDepth );
+    }
+    else
+    if( (gnSeedSource == SEED_RANDOM) || (gnSeedSource == SEED_SOBOL) )
+    {
+        if( gnSamples )
+            nCel = gnSamples;
+
+        const bool   bMirror  = bHalf;
+        const size_t nSamples = bMirror ? nCel / 2 : nCel;
+        if( bMirror )
+            nCel = 2 * nSamples;
+
+        if( gbSymmetry )
+        {
+            if( bMirror )
+                printf( "Symmetry: upper half sampled\n" );
+            else
+                printf( "Symmetry: OFF, seed Y %f .. %f isn't symmetric about the real axis\n", gnDomainMinY, gnDomainMaxY );
+        }
+
+        // Fixed size blocks of sample indices; any block may go to any thread
+        size_t nBlock = 1 << 16;
+        while( (nSamples / nBlock) >= (1 << 20) )
+            nBlock *= 2;
+
+        aWork = (WorkItem*) malloc( ((nSamples + nBlock - 1) / nBlock) * sizeof( WorkItem ) );
+        for( size_t iBegin = 0; iBegin < nSamples; iBegin += nBlock )
+        {
+            WorkItem &work = aWork[ nWork++ ];
+            work.iBegin = iBegin;
+            work.iEnd   = (iBegin + nBlock < nSamples) ? iBegin + nBlock : nSamples;
+            work.mirror = bMirror;
+        }
+    }
+    else
+    if( gnSeedSource == SEED_ADAPTIVE )
+    {
+        if( gbSymmetry )
+            printf( "Symmetry: OFF, not used by adaptive sampling\n" );
+
+        int aStride[ NUM_CELL_TYPES ], aCells[ NUM_CELL_TYPES ];
+
+        const double nPrepass = omp_get_wtime();
+            aWork = Adaptive_BuildWork( seeds, &nWork, aStride, aCells );
+        const double nPrepassElapsed = omp_get_wtime() - nPrepass;
+
+        uint64_t nSeeds = 0;
+        for( int iWork = 0; iWork < nWork; iWork++ )
+            nSeeds += aWork[ iWork ].iEnd - aWork[ iWork ].iBegin;
+
+        printf( "Adaptive: %.3f s escape map, %.2f%% of grid seeds iterated\n", nPrepassElapsed, (100.0 * nSeeds) / nCel );
+        printf( "    %d boundary cells 1:1, %d interior 1:%d, %d exterior 1:%d\n"
+            , aCells[ CELL_BOUNDARY ]
+            , aCells[ CELL_INTERIOR ], aStride[ CELL_INTERIOR ] * aStride[ CELL_INTERIOR ]
+            , aCells[ CELL_EXTERIOR ], aStride[ CELL_EXTERIOR ] * aStride[ CELL_EXTERIOR ]
+        );
+    }
+    else
+    {
+        // Each scaled row is one unit of work; the escape engine streams the seeds within it.
+        // With symmetry, skip the lower row of every mirrored pair.
+        // The axis row and rows whose mirror is outside the view are iterated as usual.
+        const int nMirror = gbSymmetry ? Symmetry_MirrorRow( gnDomainMinY, seeds.dy, nRow ) : -1;
+
+        aWork = (WorkItem*) malloc( nRow * sizeof( WorkItem ) );
+        for( int iRow = 0; iRow < (int)nRow; iRow++ )
+        {
+            const int iPair = nMirror - iRow;
+            if( (nMirror < 0) || (iPair < 0) || (iPair >= (int)nRow) || (iPair <= iRow) )
+            {
+                WorkItem &work = aWork[ nWork++ ];
+                work.iBegin = iRow * nCol;
+                work.iEnd   = work.iBegin + nCol;
+                work.mirror = (nMirror >= 0) && (iPair >= 0) && (iPair < iRow);
+                work.band   = iRow / gnScale;
+            }
+        }
+
+        if( gbSymmetry )
+        {
+            if( nMirror < 0 )
+                printf( "Symmetry: OFF, seed Y %f .. %f isn't symmetric about the real axis\n", gnDomainMinY, gnDomainMaxY );
+            else
+                printf( "Symmetry: %d / %d rows iterated\n", nWork, (int)nRow );
+        }
+    }
+
+    // The order the items were built in identifies them in a checkpoint
+    for( int iWork = 0; iWork < nWork; iWork++ )
+        aWork[ iWork ].id = iWork;
+
+    // Resume: drop the items the checkpoint has finished
+    int nResumed = 0;
+    if( gpFileNameCheckpoint )
+    {
+        if( !gaCheckpointDone )
+        {
+            gnCheckpointItems = nWork;
+            gaCheckpointDone  = (uint8_t*) calloc( Checkpoint_BitmapBytes(), 1 );
+        }
+
+        if( gnCheckpointItems != (uint64_t)nWork )
+        {
+            printf( "ERROR: Checkpoint has %llu work items, this render has %d\n", (unsigned long long) gnCheckpointItems, nWork );
+            gnCheckpointItems = 0; // tells main() the render didn't run
+            free( aWork );
+            return 0;
+        }
 
-        u = (int) ((r - gnWorldMinX) * sx); // texel x
-        v = (int) ((i - gnWorldMinY) * sy); // texel y
+        const int nTotal = nWork;
+        nWork = 0;
+        for( int iWork = 0; iWork < nTotal; iWork++ )
+        {
+            const WorkItem &work = aWork[ iWork ];
+            if( gaCheckpointDone[ work.id >> 3 ] & (1 << (work.id & 7)) )
+                nCel -= (work.iEnd - work.iBegin) * (work.mirror ? 2 : 1)
+                      * ((gnSeedSource == SEED_ADAPTIVE) ? work.weight : 1);
+            else
+                aWork[ nWork++ ] = work;
+        }
 
-        if( (u < width) && (v < height) && (u >= 0) && (v >= 0) )
-            texels[ (v * width) + u ]++;
+        nResumed = nTotal - nWork;
+        if( gpFileNameResume )
+            printf( "Resume: %d / %d work items done\n", nResumed, nTotal );
     }
-}
 
+    if( gnSeedSource == SEED_GRID )
+    {
+        const int nBands = (int)((nRow + gnScale - 1) / gnScale);
 
-// @return Number of input scaled pixels (Not uber total of all pixels processed)
-// ========================================================================
-int Buddhabrot()
-{
-    if( gnScale < 0)
-        gnScale = 1;
+        if( gnOrder == ORDER_LJF )
+        {
+            // Guided and static size ranges by seed count, so the most expensive
+            // rows first would only make the first ranges the longest
+            if( gnSchedule != SCHEDULE_COST )
+                printf( "Order: rows, ljf needs -sched cost; %s ranges are sized by seed count\n", gaScheduleName[ gnSchedule ] );
+            else
+            {
+                gaCostBand = (double*) calloc( nBands, sizeof( double ) );
 
-    const size_t nCol = gnWidth  * gnScale ; // scaled width
-    const size_t nRow = gnHeight * gnScale ; // scaled height
+                if( gpFileNameCostMap && Cost_Load( gpFileNameCostMap, nBands ) )
+                    printf( "Order: ljf, cost map from %s\n", gpFileNameCostMap );
+                else
+                {
+                    const double nEstimate = omp_get_wtime();
+                        Cost_Estimate( seeds, nRow, nBands );
+                    printf( "Order: ljf, cost map estimated in %.3f s\n", omp_get_wtime() - nEstimate );
+                }
 
-    /* */ size_t iCel = 0                  ; // Progress status for percent compelete
-    const size_t nCel = nCol     * nRow    ; // scaled width  * scaled height;
+                qsort( aWork, nWork, sizeof( WorkItem ), Work_CompareCost );
+                free( gaCostBand );
+                gaCostBand = NULL;
+            }
+        }
 
-    const double nWorldW = gnWorldMaxX - gnWorldMinX;
-    const double nWorldH = gnWorldMaxY - gnWorldMinY;
+        // A resumed render only times the rows left, which would overwrite a complete map
+        if( gpFileNameCostMap && nResumed )
+            printf( "Cost map: not saved, %d work items were done before the resume\n", nResumed );
+        else
+        if( gpFileNameCostMap )
+        {
+            gaCostMeasured = (double*) calloc( nBands, sizeof( double ) );
+            gnCostBands    = nBands;
+        }
+    }
 
-    // Map Source (world space) to Pixels (image space)
-    const double nWorld2ImageX = (double)(gnWidth  - 1.) / nWorldW;
-    const double nWorld2ImageY = (double)(gnHeight - 1.) / nWorldH;
+    // Seeds before each work item, to find the items a range of seeds spans
+    size_t *aFirst = (size_t*) malloc( (nWork + 1) * sizeof( size_t ) );
+    aFirst[ 0 ] = 0;
+    for( int iWork = 0; iWork < nWork; iWork++ )
+        aFirst[ iWork + 1 ] = aFirst[ iWork ] + (aWork[ iWork ].iEnd - aWork[ iWork ].iBegin);
 
-    const double dx = nWorldW / (nCol - 1.0);
-    const double dy = nWorldH / (nRow - 1.0);
+    // 1. Scatter, in epochs of whole work items with a checkpoint after each one that
+    // ends near the interval. Without -checkpoint there is one epoch.
+    memset( gaThreadsSchedule, 0, sizeof( gaThreadsSchedule ) );
 
-    char sDenominator[ 32 ];
-    itoaComma( nCel, sDenominator );
+    const double nScatter    = omp_get_wtime();
+    const double nInterval   = gnCheckpointMinutes * 60.;
+    /* */ double nCheckpoint = nScatter + nInterval; // next one due
+    /* */ int    iWorkBegin  = 0;
 
-// BEGIN OMP
-    // 1. Scatter
+    Progress_Start( nCel, gnThreadsActive, gbVerbose );
 
-    // Linearize to 1D
-#pragma omp parallel for
-// END OMP
-    for( size_t iPix = 0; iPix < nCel; iPix++ )
+    while( iWorkBegin < nWork )
     {
-// BEGIN OMP
-#pragma omp atomic
-        iCel++;
+        const int iWorkEnd = gpFileNameCheckpoint
+            ? Checkpoint_EpochEnd( aFirst, nWork, iWorkBegin, nScatter, nCheckpoint )
+            : nWork;
 
-        const int       iTid = omp_get_thread_num(); // Get Thread Index: 0 .. nCores-1
-        /* */ uint16_t* pTex = gaThreadsTexels[ iTid ];
-// END OMP
+        Scatter( seeds, aWork, aFirst, nWork, aFirst[ iWorkBegin ], aFirst[ iWorkEnd ], nWorld2ImageX, nWorld2ImageY );
 
-        const size_t    iCol = iCel % nCol;
-        const size_t    iRow = iCel / nCol;
+        for( int iWork = iWorkBegin; iWork < iWorkEnd && gaCheckpointDone; iWork++ )
+            gaCheckpointDone[ aWork[ iWork ].id >> 3 ] |= (uint8_t)(1 << (aWork[ iWork ].id & 7));
+        iWorkBegin = iWorkEnd;
 
-        const double    x = gnWorldMinX + (iCol * dx);
-        const double    y = gnWorldMinY + (iRow * dy);
+        // The last epoch checkpoints too, so the file always ends with the latest state
+        if( gpFileNameCheckpoint && ((iWorkBegin == nWork) || (omp_get_wtime() >= nCheckpoint - CHECKPOINT_SLACK * nInterval)) )
+        {
+            Checkpoint_Save();
+            nCheckpoint = omp_get_wtime() + nInterval;
+        }
+    }
 
-        /* */ double    r = 0., i = 0., s, j;
+    Progress_Stop();
+    free( aFirst );
+    Schedule_Report( nScatter );
 
-            for (int depth = 0; depth < gnMaxDepth; depth++)
-            {
-                s = (r*r - i*i) + x; // Zn+1 = Zn^2 + C<x,y>
-                j = (2.0*r*i)   + y;
+    if( gnCheckpoints )
+        printf( "Checkpoint: %d saved to %s in %.3f s, %.2f%% of the scatter\n"
+            , gnCheckpoints, gpFileNameCheckpoint, gnCheckpointSeconds
+            , (100.0 * gnCheckpointSeconds) / (omp_get_wtime() - nScatter) );
 
-                r = s;
-                i = j;
+    if( gaCostMeasured )
+    {
+        if( Cost_Save( gpFileNameCostMap, gnCostBands ) )
+            printf( "Cost map: saved to %s\n", gpFileNameCostMap );
+        else
+            printf( "ERROR: Couldn't save cost map: %s\n", gpFileNameCostMap );
 
-                if ((r*r + i*i) > 4.0) // escapes to infinity so trace path
-                {
-                    plot( x, y, nWorld2ImageX, nWorld2ImageY, pTex, gnWidth, gnHeight, depth );
-                    break;
-                }
-            }
+        free( gaCostMeasured );
+        gaCostMeasured = NULL;
+    }
 
-        VERBOSE
 // BEGIN OMP
-        if( (iTid == 0) && ((iCel & 0xFFFF) == 0) )
-// END OMP
-        {
-            // We no longer need a critical section
-            // since we only allow thread 0 to print
-            {
-                const size_t n = iCel;
-                const double percent = (100.0 * n) / nCel;
-                static char  sNumerator[ 32 ];
-                itoaComma( n, sNumerator );
+    // 2. Gather, not needed with tile ownership
+    if( gbBinning && (gnAccumulate != ACCUMULATE_OWNER) )
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+            Staging_Flush( gaThreadsStaging[ iThread ] );
 
-                printf( "%6.2f%% = %s / %s%s", percent, sNumerator, sDenominator, gaBackspace );
-                fflush( stdout );
-            }
-        }
-    }
+    const double nGather = omp_get_wtime();
+    const int    nPix    = gnWidth  * gnHeight; // Normal area
 
-// BEGIN OMP
-    // 2. Gather
-    const int nPix = gnWidth  * gnHeight; // Normal area
-    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
-    {
-        const uint16_t *pSrc = gaThreadsTexels[ iThread ];
-        /* */ uint16_t *pDst = gpGreyscaleTexels;
+    if( gnAccumulate == ACCUMULATE_COPIES )
+        Gather_Copies();
+
+    if( gnAccumulate == ACCUMULATE_BYTES )
+        Gather_Bytes();
 
+    if( gnAccumulate == ACCUMULATE_SPARSE )
+        Gather_Sparse();
+
+    if( gnAccumulate == ACCUMULATE_ATOMIC )
+    {
+#pragma omp parallel for schedule(static)
         for( int iPix = 0; iPix < nPix; iPix++ )
-            *pDst++ += *pSrc++;
+            for( int iStripe = 1; iStripe < gnAtomicStripes; iStripe++ )
+                gpCountTexels[ iPix ] += gaAtomicStripes[ iStripe ][ iPix ];
     }
+
+    const double nGatherElapsed = omp_get_wtime() - nGather;
 // END OMP
 
+    free( aWork );
+
+    const double nResolve = omp_get_wtime();
+        Counts_Resolve();
+    const double nResolveElapsed = omp_get_wtime() - nResolve;
+
+    printf( "Gather: %.3f s, resolve %.3f s\n", nGatherElapsed, nResolveElapsed );
     return nCel;
 }
 
@@ -626,23 +4451,70 @@ int Usage()
 "Usage: [width [height [depth [scale]]]]\n"
 "\n"
 "-?       Display usage help\n"
+"-adaptive# Escape map pre-pass, then only every #th seed (both ways) in interior cells (Default: scale)\n"
+"-atomic# All threads add into # shared images with atomic adds instead of a 16-bit copy each (Default: %d, auto when the copies won't fit in RAM)\n"
 "-b       Use auto brightness\n"
+"-bin#    Stage deposits and apply them tile by tile, # K entries per thread (Default: %d)\n"
 "-bmp foo Save .BMP as filename foo\n"
+"-checkpoint# foo  Every # minutes append the counts changed and the work items done to foo (Default: %.0f)\n"
+"-copies  Always use a dense 16-bit copy per thread, the fastest when every thread hits most of the image\n"
+"-costmap foo  Order grid rows by the cost per row the last run measured into foo, then save this run's\n"
+"-cull#   Skip seeds inside the main cardioid and period 2 bulb, and bulbs of period 3..# if given\n"
+"-domain x0 x1 y0 y1  Take seeds from this part of the complex plane (Default: same as -world)\n"
+"-extend foo bar  Continue the seeds saved in foo by -pending to a deeper depth and add them to raw bar\n"
+"-huge    Back the image buffers with transparent 2 MB pages (fewer TLB misses on deposits)\n"
+"-hugetlb Back the image buffers with reserved 2 MB pages (vm.nr_hugepages), else as -huge\n"
 // BEGIN OMP
 "-j#      Use this # of threads. (Default: %d)\n"
 // END OMP
+"-mh#     Metropolis-Hastings seeds biased toward orbits that cross the view, # samples with K/M/G suffix (Default: same as grid)\n"
+"-pending foo  Save the seeds still running at max depth to foo, for -extend\n"
+"-pin     Pin thread i to CPU i, filling one NUMA node before the next\n"
+"-pinnode Pin threads to NUMA nodes, an equal share of the threads per node\n"
+"-period# Stop orbits that revisit a point within 10^-# (Default: %d)\n"
+"-orbit#  Record escaping orbits instead of re-iterating them, # MB per thread (Default: %d)\n"
+"-order x Grid row order: ljf (predicted most expensive first) or rows (Default: %s)\n"
+"-own     One shared image: each tile's deposits are queued to the thread that owns it, no per-thread copies or gather\n"
 "--no-bmp Don't save .BMP  (Default: %s)\n"
 "--no-raw Don't save .data (Default: %s)\n"
 "--no-rot Don't rotate BMP (Default: %s)\n"
+"--resume foo  Continue the render checkpointed in foo with its settings, checkpointing on into foo\n"
+"-qmc#    Quasi-random (Sobol) seeds instead of a grid, # samples with K/M/G suffix (Default: same as grid)\n"
 "-r       Rotation output bitmap 90 degrees right\n"
 "-raw foo Save raw greyscale as foo\n"
+"-random# Uniform random seeds instead of a grid, # samples with K/M/G suffix (Default: same as grid)\n"
+"-rng#    Random key, selects an independent sample stream or Sobol shift (Default: %llu)\n"
+"-sched x Seed loop schedule: cost (ranges sized from their measured cost), guided or static (Default: %s)\n"
+// BEGIN SIMD
+"-simd    Use widest vector escape engine available (Default: %s)\n"
+"-simd4   Use AVX2    escape engine, 4 seeds at a time\n"
+"-simd8   Use AVX-512 escape engine, 8 seeds at a time\n"
+// END SIMD
+"-sparse  Per-thread copies as 64x64 tiles allocated on first deposit (Default: auto when a -domain wider than the view probes under 1/8 of the tiles per thread)\n"
+"-sym     Only iterate seeds with imaginary part >= 0 and mirror their orbits, if the view is symmetric\n"
+"-tiled#  Store the image as # x # tiles instead of rows, converted to rows for output (Default: %d)\n"
+"-u8      8-bit per-thread copies instead of 16-bit; a counter that passes 255 is logged and added into the shared counts\n"
 "-v       Verbose.  Display %% complete\n"
+"-world x0 x1 y0 y1  World (complex plane) view (Default: %f %f %f %f)\n"
+        , gnAtomicStripes
+        , gnBinEntries >> 10
+        , gnCheckpointMinutes
 // BEGIN OMP
         , gnThreadsMaximum
 // END OMP
+        , gnPeriodExponent
+        , gnOrbitBudgetMB
+        , gaOrderName[ gnOrder ]
         , aSaved[ (int) gbSaveBMP          ]
         , aOffOn[ (int) gbRotateOutput     ]
         , aOffOn[ (int) gbSaveRawGreyscale ]
+        , (unsigned long long) gnRandomKey
+        , gaScheduleName[ gnSchedule ]
+// BEGIN SIMD
+        , gaEscapeEngineName[ gnEscapeEngine ]
+// END SIMD
+        , 1 << LAYOUT_SHIFT
+        , gnWorldMinX, gnWorldMaxX, gnWorldMinY, gnWorldMaxY
     );
 
     return 0;
@@ -662,6 +4534,25 @@ void Text_CopyFileName( char *buffer, const char *source, const size_t maxlen )
 }
 
 
+// @return count with optional K, M, G suffix (x1000) e.g. 2G = 2,000,000,000
+// ========================================================================
+uint64_t Text_ParseCount( const char *text )
+{
+    char    *pEnd;
+    uint64_t nCount = strtoull( text, &pEnd, 10 );
+
+    switch( *pEnd )
+    {
+        case 'k': case 'K': nCount *= 1000ULL;       break;
+        case 'm': case 'M': nCount *= 1000000ULL;    break;
+        case 'g': case 'G': nCount *= 1000000000ULL; break;
+        default: break;
+    }
+
+    return nCount;
+}
+
+
 // ========================================================================
 int main( int nArg, char * aArg[] )
 {
@@ -686,18 +4577,58 @@ int main( int nArg, char * aArg[] )
                 iArg++;
                 pArg++; // point to 1st char in option
 
-                if( strcmp( pArg, "--no-bmp" ) == 0 )
+                if( strcmp( pArg, "-no-bmp" ) == 0 ) // pArg is past the 1st '-'
                     gbSaveBMP = false;
                 else 
-                if( strcmp( pArg, "--no-raw" ) == 0 )
+                if( strcmp( pArg, "-no-raw" ) == 0 )
                     gbSaveRawGreyscale = false;
                 else 
-                if( strcmp( pArg, "--no-rot" ) == 0 )
+                if( strcmp( pArg, "-no-rot" ) == 0 )
                     gbRotateOutput = false;
                 else 
                 if( (*pArg == '?') || (strcmp( pArg, "-help" ) == 0) )
                     return Usage();
                 else
+                if( strncmp( pArg, "adaptive", 8 ) == 0 )
+                {
+                    gnSeedSource     = SEED_ADAPTIVE;
+                    gnAdaptiveStride = atoi( pArg+8 );
+                }
+                else
+                if( strncmp( pArg, "atomic", 6 ) == 0 )
+                {
+                    gnAccumulate = ACCUMULATE_ATOMIC;
+                    int i = atoi( pArg+6 );
+                    if( i > 0 )
+                        gnAtomicStripes = i;
+                }
+                else
+                if( strcmp( pArg, "extend" ) == 0 )
+                {
+                    if( (iArg + 2) < nArg )
+                    {
+                        gpFileNameExtend = aArg[ ++iArg ];
+                        gpFileNameBase   = aArg[ ++iArg ];
+                    }
+                }
+                else
+                if( strcmp( pArg, "copies" ) == 0 )
+                    gnAccumulate = ACCUMULATE_COPIES;
+                else
+                if( strncmp( pArg, "cull", 4 ) == 0 )
+                {
+                    gbCullInterior = true;
+                    gnCullPeriod   = atoi( pArg+4 );
+                }
+                else
+                if( strncmp( pArg, "bin", 3 ) == 0 )
+                {
+                    gbBinning = true;
+                    int i = atoi( pArg+3 );
+                    if( i > 0 )
+                        gnBinEntries = i << 10;
+                }
+                else
                 if( *pArg == 'b' && (strcmp( pArg, "bmp") != 0) ) // -b and -bmp
                     gbAutoBrightness = true;
                 else
@@ -730,12 +4661,182 @@ int main( int nArg, char * aArg[] )
                 }
                 else
 // END OMP
+                if( strcmp( pArg, "huge" ) == 0 )
+                    gnHugePages = HUGE_THP;
+                else
+                if( strcmp( pArg, "hugetlb" ) == 0 )
+                    gnHugePages = HUGE_TLB;
+                else
+                if( strcmp( pArg, "pin" ) == 0 )
+                    gnPin = PIN_CORE;
+                else
+                if( strcmp( pArg, "pinnode" ) == 0 )
+                    gnPin = PIN_NODE;
+                else
+                if( strcmp( pArg, "order" ) == 0 )
+                {
+                    const char *pName = (iArg + 1 < nArg) ? aArg[ ++iArg ] : "";
+
+                    gnOrder = 0;
+                    while( (gnOrder < NUM_ORDER) && strcmp( pName, gaOrderName[ gnOrder ] ) )
+                        gnOrder++;
+
+                    if( gnOrder == NUM_ORDER )
+                    {
+                        printf( "ERROR: Unknown order: %s, expected ljf or rows\n", pName );
+                        return 1;
+                    }
+                }
+                else
+                if( strcmp( pArg, "costmap" ) == 0 )
+                {
+                    if( (iArg + 1) < nArg )
+                        gpFileNameCostMap = aArg[ ++iArg ];
+                }
+                else
+                if( strncmp( pArg, "checkpoint", 10 ) == 0 )
+                {
+                    if( pArg[10] )
+                        gnCheckpointMinutes = atof( pArg+10 );
+                    if( gnCheckpointMinutes <= 0. )
+                    {
+                        printf( "ERROR: -checkpoint# minutes must be more than 0: %s\n", pArg+10 );
+                        return 1;
+                    }
+                    if( (iArg + 1) < nArg )
+                        gpFileNameCheckpoint = aArg[ ++iArg ];
+                }
+                else
+                if( strcmp( pArg, "-resume" ) == 0 ) // pArg is past the 1st '-'
+                {
+                    if( (iArg + 1) < nArg )
+                        gpFileNameResume = aArg[ ++iArg ];
+                }
+                else
+                if( strcmp( pArg, "pending" ) == 0 )
+                {
+                    if( (iArg + 1) < nArg )
+                        gpFileNamePending = aArg[ ++iArg ];
+                }
+                else
+                if( strncmp( pArg, "period", 6 ) == 0 )
+                {
+                    gbPeriodic = true;
+                    if( pArg[6] )
+                        gnPeriodExponent = atoi( pArg+6 );
+                }
+                else
+                if( strncmp( pArg, "orbit", 5 ) == 0 )
+                {
+                    gbOrbitCache = true;
+                    int i = atoi( pArg+5 );
+                    if( i > 0 )
+                        gnOrbitBudgetMB = i;
+                }
+                else
+                if( strcmp( pArg, "own" ) == 0 )
+                {
+                    gnAccumulate = ACCUMULATE_OWNER;
+                    gbBinning    = true; // parcels are cut from the staged deposits
+                }
+                else
+// BEGIN SIMD
+                if( strcmp( pArg, "simd" ) == 0 )
+                    gnEscapeEngine = Escape_DetectEngine();
+                else
+                if( strcmp( pArg, "simd4" ) == 0 )
+                    gnEscapeEngine = ESCAPE_AVX2;
+                else
+                if( strcmp( pArg, "simd8" ) == 0 )
+                    gnEscapeEngine = ESCAPE_AVX512;
+                else
+// END SIMD
+                if( strncmp( pArg, "qmc", 3 ) == 0 )
+                {
+                    gnSeedSource = SEED_SOBOL;
+                    gnSamples    = Text_ParseCount( pArg+3 );
+                }
+                else
+                if( strncmp( pArg, "random", 6 ) == 0 )
+                {
+                    gnSeedSource = SEED_RANDOM;
+                    gnSamples    = Text_ParseCount( pArg+6 );
+                }
+                else
+                if( strncmp( pArg, "mh", 2 ) == 0 )
+                {
+                    gnSeedSource = SEED_METROPOLIS;
+                    gnSamples    = Text_ParseCount( pArg+2 );
+                }
+                else
+                if( strncmp( pArg, "rng", 3 ) == 0 )
+                    gnRandomKey = strtoull( pArg+3, NULL, 0 );
+                else
+                if( strcmp( pArg, "sched" ) == 0 )
+                {
+                    const char *pName = (iArg + 1 < nArg) ? aArg[ ++iArg ] : "";
+
+                    gnSchedule = 0;
+                    while( (gnSchedule < NUM_SCHEDULE) && strcmp( pName, gaScheduleName[ gnSchedule ] ) )
+                        gnSchedule++;
+
+                    if( gnSchedule == NUM_SCHEDULE )
+                    {
+                        printf( "ERROR: Unknown schedule: %s, expected cost, guided or static\n", pName );
+                        return 1;
+                    }
+                }
+                else
+                if( strcmp( pArg, "sparse" ) == 0 )
+                    gnAccumulate = ACCUMULATE_SPARSE;
+                else
+                if( strcmp( pArg, "u8" ) == 0 )
+                    gnAccumulate = ACCUMULATE_BYTES;
+                else
                 if( *pArg == 'r' && (strcmp( pArg, "raw") != 0) ) // -r and -raw
                     gbRotateOutput = true;
                 else
+                if( strcmp( pArg, "sym" ) == 0 )
+                    gbSymmetry = true;
+                else
+                if( strncmp( pArg, "tiled", 5 ) == 0 )
+                {
+                    const int size = pArg[5] ? atoi( pArg+5 ) : 1 << LAYOUT_SHIFT;
+                    for( gnLayoutShift = 1; (1 << gnLayoutShift) < size; gnLayoutShift++ )
+                        ;
+                    if( (size < 2) || (size > 256) || ((1 << gnLayoutShift) != size) )
+                    {
+                        printf( "ERROR: -tiled# tile size must be a power of 2 from 2 to 256: %s\n", pArg+5 );
+                        return 1;
+                    }
+                }
+                else
                 if( *pArg == 'v' )
                     gbVerbose = true;
                 else
+                if( strcmp( pArg, "domain" ) == 0 )
+                {
+                    if( (iArg + 4) < nArg )
+                    {
+                        gbDomain     = true;
+                        gnDomainMinX = atof( aArg[ ++iArg ] );
+                        gnDomainMaxX = atof( aArg[ ++iArg ] );
+                        gnDomainMinY = atof( aArg[ ++iArg ] );
+                        gnDomainMaxY = atof( aArg[ ++iArg ] );
+                    }
+                }
+                else
+                if( strcmp( pArg, "world" ) == 0 )
+                {
+                    if( (iArg + 4) < nArg )
+                    {
+                        gnWorldMinX = atof( aArg[ ++iArg ] );
+                        gnWorldMaxX = atof( aArg[ ++iArg ] );
+                        gnWorldMinY = atof( aArg[ ++iArg ] );
+                        gnWorldMaxY = atof( aArg[ ++iArg ] );
+                    }
+                }
+                else
                 if( strcmp( pArg, "raw" ) == 0 )
                 {
                     int n = iArg+1; 
@@ -767,28 +4868,235 @@ int main( int nArg, char * aArg[] )
     if ((iArg+3) < nArg) gnMaxDepth = atoi( aArg[iArg+3] );
     if ((iArg+4) < nArg) gnScale    = atoi( aArg[iArg+4] );
 
+    if( gpFileNameExtend )
+    {
+        if( !Pending_Load( gpFileNameExtend ) )
+        {
+            printf( "ERROR: Couldn't read pending seeds: %s\n", gpFileNameExtend );
+            return 1;
+        }
+
+        if( gnMaxDepth <= gnPendingDepth )
+        {
+            printf( "ERROR: Depth %d must be deeper than the %d the seeds were saved at\n", gnMaxDepth, gnPendingDepth );
+            return 1;
+        }
+
+        gnSeedSource = SEED_RESUME;
+    }
+
+    if( gpFileNameResume )
+    {
+        if( !Checkpoint_LoadHeader( gpFileNameResume ) )
+        {
+            printf( "ERROR: Couldn't read checkpoint: %s\n", gpFileNameResume );
+            return 1;
+        }
+
+        if( !gpFileNameCheckpoint )
+            gpFileNameCheckpoint = gpFileNameResume;
+    }
+
+    if( gpFileNameCheckpoint )
+    {
+        if( (gnSeedSource == SEED_METROPOLIS) || gpFileNameExtend || gpFileNamePending )
+        {
+            printf( "ERROR: -checkpoint# isn't supported with -mh, -extend or -pending\n" );
+            return 1;
+        }
+
+        // A checkpoint merges the per-thread copies; the other policies keep state it doesn't save
+        if( ((gnAccumulate != ACCUMULATE_AUTO) && (gnAccumulate != ACCUMULATE_COPIES)) || gbBinning )
+            printf( "WARNING: -checkpoint# always uses -copies\n" );
+
+        gnAccumulate = ACCUMULATE_COPIES;
+        gbBinning    = false;
+    }
+
+    if( !gbDomain )
+    {
+        gnDomainMinX = gnWorldMinX;
+        gnDomainMaxX = gnWorldMaxX;
+        gnDomainMinY = gnWorldMinY;
+        gnDomainMaxY = gnWorldMaxY;
+    }
+
     printf( "Width: %d  Height: %d  Depth: %d  Scale: %d  RotateBMP: %d  SaveRaw: %d\n", gnWidth, gnHeight, gnMaxDepth, gnScale, gbRotateOutput, gbSaveRawGreyscale );
 
+// BEGIN SIMD
+    if( gnEscapeEngine > Escape_DetectEngine() )
+    {
+        printf( "WARNING: %s not supported by this CPU\n", gaEscapeEngineName[ gnEscapeEngine ] );
+        gnEscapeEngine = Escape_DetectEngine();
+    }
+// END SIMD
+
+    // Before the sparse probe in AllocImageMemory(), which escapes the same way
+    if( gbCullInterior )
+    {
+        printf( "Interior culling: cardioid, period 2" );
+        if( gnCullPeriod > 2 )
+            printf( ", %d bulb discs of period 3..%d", Interior_BuildTable( gnCullPeriod ), gnCullPeriod );
+        printf( "\n" );
+    }
+    if( gbPeriodic )
+    {
+        const double nTolerance = pow( 10.0, -gnPeriodExponent );
+        gnPeriodTolerance2 = nTolerance * nTolerance;
+        printf( "Periodicity: tolerance %g\n", nTolerance );
+    }
+
     AllocImageMemory( gnWidth, gnHeight );
 
+    if( gpFileNameExtend && !RAW_ReadGreyscale( gpFileNameBase, gpCountTexels, gnWidth, gnHeight ) )
+    {
+        printf( "ERROR: Couldn't read %dx%d raw: %s\n", gnWidth, gnHeight, gpFileNameBase );
+        return 1;
+    }
+
+    if( gpFileNameExtend )
+        Layout_Convert( false );
+
+    if( gpFileNameCheckpoint )
+        gaCheckpointDirty = (uint8_t*) calloc( (size_t) Checkpoint_Blocks(), 1 );
+
+    if( gpFileNameResume )
+    {
+        if( !Checkpoint_LoadState( gpFileNameResume ) )
+        {
+            printf( "ERROR: Checkpoint has no complete record: %s\n", gpFileNameResume );
+            return 1;
+        }
+
+        // Writing to a new file starts it with a snapshot
+        if( strcmp( gpFileNameResume, gpFileNameCheckpoint ) != 0 )
+            gnCheckpointBytes = 0;
+    }
+
 // BEGIN OMP
     printf( "Using: %u / %u threads\n", gnThreadsActive, gnThreadsMaximum );
+    if( (gnNumaNodes > 1) || (gnPin != PIN_NONE) )
+    {
+        int aThreads[ MAX_NODES ] = {};
+        for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+            aThreads[ gaThreadsNode[ iThread ] ]++;
+
+        printf( "NUMA: %d node%s, pin %s, threads per node:", gnNumaNodes, (gnNumaNodes == 1) ? "" : "s", gaPinName[ gnPin ] );
+        for( int iNode = 0; iNode < gnNumaNodes; iNode++ )
+            printf( " %d", aThreads[ iNode ] );
+        printf( "\n" );
+    }
 // END OMP
+// BEGIN SIMD
+    printf( "Escape: %s\n", gaEscapeEngineName[ gnEscapeEngine ] );
+// END SIMD
+    if( gbDomain )
+        printf( "Domain: %f %f %f %f\n", gnDomainMinX, gnDomainMaxX, gnDomainMinY, gnDomainMaxY );
+    if( gnSeedSource == SEED_RANDOM )
+        printf( "Seeds: random, key %llu\n", (unsigned long long) gnRandomKey );
+    if( gnSeedSource == SEED_SOBOL )
+        printf( "Seeds: Sobol, key %llu\n", (unsigned long long) gnRandomKey );
+    if( gnSeedSource == SEED_METROPOLIS )
+        printf( "Seeds: Metropolis-Hastings, %d chains, key %llu\n", gnThreadsActive, (unsigned long long) gnRandomKey );
+    if( gbBinning )
+        printf( "Binning: %dK deposits/thread, %d tiles of %dx%d\n", gnBinEntries >> 10, gnBinTiles, 1 << gnBinTileShift, 1 << gnBinTileShift );
+    if( gnSeedSource != SEED_METROPOLIS )
+    {
+        printf( "Accumulate: %s", gaAccumulateName[ gnAccumulate ] );
+        if( gnAccumulate == ACCUMULATE_OWNER )
+            printf( ", %d tiles over %d threads, %d batches/thread", gnBinTiles, gnThreadsActive, OWNER_BATCHES );
+        if( gnAccumulate == ACCUMULATE_ATOMIC )
+            printf( ", %d stripe%s", gnAtomicStripes, (gnAtomicStripes == 1) ? "" : "s" );
+        printf( "\n" );
+    }
+    if( gnHugePages != HUGE_OFF )
+        printf( "Huge pages: %s\n", gaHugePagesName[ gnHugePages ] );
+    if( gnLayoutShift )
+        printf( "Layout: %dx%d tiles\n", 1 << gnLayoutShift, 1 << gnLayoutShift );
+    if( gbOrbitCache )
+        printf( "Orbit cache: %d MB/thread, %d points scalar, %d points SIMD\n", gnOrbitBudgetMB, gnOrbitCapacity, (int) gnOrbitRing );
 
     Timer stopwatch;
     stopwatch.Start();
-        int nCells = Buddhabrot();
+// BEGIN OMP
+    const double nBegin   = omp_get_wtime();
+// END OMP
+        uint64_t nCells = Buddhabrot();
+// BEGIN OMP
+    const double nElapsed = omp_get_wtime() - nBegin;
+// END OMP
     stopwatch.Stop();
 
-    VERBOSE printf( "100.00%%\n" );
+    if( gpFileNameCheckpoint && !gnCheckpointItems )
+        return 1;
+
     stopwatch.Throughput( nCells ); // Calculate throughput in pixels/s
-    printf( "%d %cpix/s (%d pixels, %.f seconds = %s%s)\n"
+    printf( "%d %cpix/s (%s pixels, %.f seconds = %s%s)\n"
         , (int)stopwatch.throughput.per_sec, stopwatch.throughput.prefix
-        , nCells
+        , itoaComma( nCells )
         , stopwatch.elapsed
         , stopwatch.day
         , stopwatch.hms
     );
+// BEGIN OMP
+    printf( "Deposits: %s in %.2f s, %.1f M/s\n", itoaComma( gnDeposits ), nElapsed, gnDeposits / (nElapsed * 1e6) );
+// END OMP
+
+    ThreadStats total = {};
+    for( int iThread = 0; iThread < gnThreadsActive; iThread++ )
+    {
+        total.nEscaped     += gaThreadsStats[ iThread ].nEscaped    ;
+        total.nOrbitCached += gaThreadsStats[ iThread ].nOrbitCached;
+        total.nCulled      += gaThreadsStats[ iThread ].nCulled     ;
+        total.nPeriodic    += gaThreadsStats[ iThread ].nPeriodic   ;
+        total.nSamples     += gaThreadsStats[ iThread ].nSamples    ;
+        total.nProposed    += gaThreadsStats[ iThread ].nProposed   ;
+        total.nAccepted    += gaThreadsStats[ iThread ].nAccepted   ;
+        total.nUniform     += gaThreadsStats[ iThread ].nUniform    ;
+        total.nUniformHits += gaThreadsStats[ iThread ].nUniformHits;
+        total.nVisitHits   += gaThreadsStats[ iThread ].nVisitHits  ;
+    }
+
+    if( gnSeedSource == SEED_METROPOLIS )
+    {
+        // Contribution = orbit points in the view per sample; noise for a given
+        // number of samples goes down roughly with its square root
+        const double nUniformF = total.nUniform  ? (double) total.nUniformHits / total.nUniform  : 0.;
+        const double nChainF   = total.nSamples  ? (double) total.nVisitHits   / total.nSamples  : 0.;
+        printf( "Metropolis: %.2f%% of %s mutations accepted\n", total.nProposed ? (100.0 * total.nAccepted) / total.nProposed : 0., itoaComma( total.nProposed ) );
+        printf( "Contribution: %.3f view points/sample vs %.3f uniform (%.1fx)\n", nChainF, nUniformF, nUniformF > 0. ? nChainF / nUniformF : 0. );
+    }
+
+    if( gbCullInterior )
+        printf( "Culled: %s interior seeds (%.2f%%)\n", itoaComma( total.nCulled ), (100.0 * total.nCulled) / nCells );
+
+    if( gbPeriodic )
+        printf( "Periodic: %s seeds stopped early (%.2f%%)\n", itoaComma( total.nPeriodic ), (100.0 * total.nPeriodic) / nCells );
+
+    if( gbOrbitCache )
+    {
+        printf( "Orbits cached: %s", itoaComma( total.nOrbitCached ) );
+        printf( " / %s escaped\n"   , itoaComma( total.nEscaped     ) );
+    }
+
+    if( gpFileNamePending )
+    {
+        if( gnSeedSource == SEED_METROPOLIS )
+            printf( "WARNING: -pending isn't supported by Metropolis sampling\n" );
+        else
+        {
+            // Adaptive seeds are saved by their grid index
+            const int     nSource = (gnSeedSource == SEED_RESUME  ) ? gnPendingSource
+                                  : (gnSeedSource == SEED_ADAPTIVE) ? (int)SEED_GRID
+                                  :                                   gnSeedSource;
+            const int64_t nSaved  = Pending_Save( gpFileNamePending, nSource );
+
+            if( nSaved < 0 )
+                printf( "ERROR: Couldn't save pending seeds: %s\n", gpFileNamePending );
+            else
+                printf( "Pending: %s seeds still running at depth %d saved to %s\n", itoaComma( nSaved ), gnMaxDepth, gpFileNamePending );
+        }
+    }
 
     int nMaxBrightness = Image_Greyscale16bitToBrightnessBias( &gnGreyscaleBias, &gnScaleR, &gnScaleG, &gnScaleB ); // don't need max brightness
     printf( "Max brightness: %d\n", nMaxBrightness );
@@ -800,21 +5108,35 @@ int main( int nArg, char * aArg[] )
 
     if( gbSaveRawGreyscale )
     {
+        // Only use wider texels when the counts don't fit
+        const int nBits = (gnMaxCount > 0xFFFFFFFFULL) ? 64
+                        : (gnMaxCount > 0xFFFF       ) ? 32
+                        :                                16;
+
         if( gpFileNameRAW )
             Text_CopyFileName( filenameRAW, gpFileNameRAW, PATH_SIZE-1 ); 
         else
-            sprintf( filenameRAW, "raw_%s_%dx%d_d%d_s%d_j%d.u16.data"
-                , pBaseName, gnWidth, gnHeight, gnMaxDepth, gnScale, gnThreadsActive );
+            sprintf( filenameRAW, "raw_%s_%dx%d_d%d_s%d_j%d.u%d.data"
+                , pBaseName, gnWidth, gnHeight, gnMaxDepth, gnScale, gnThreadsActive, nBits );
 
-        RAW_WriteGreyscale16bit( filenameRAW, gpGreyscaleTexels, gnWidth, gnHeight );
+        if( nBits == 16 )
+            RAW_WriteGreyscale16bit( filenameRAW, gpGreyscaleTexels, gnWidth, gnHeight );
+        else
+        {
+            Layout_Convert( true );
+            RAW_WriteGreyscaleWide( filenameRAW, gpCountTexels, gnWidth, gnHeight, nBits );
+        }
         printf( "Saved: %s\n", filenameRAW );
+
+        if( nBits > 16 )
+            printf( "NOTE: Brightest count %s doesn't fit in 16 bits; raw is %d-bit, BMP is saturated\n", itoaComma( gnMaxCount ), nBits );
     }
 
     uint16_t *pRotatedTexels = gpGreyscaleTexels; // [ height ][ width ] 16-bit greyscale pre-BMP
-    if( gbRotateOutput )
+    if( gbRotateOutput && gbSaveBMP )
     {
         const int nBytes =  gnImageArea * sizeof( uint16_t );
-        pRotatedTexels = (uint16_t*) malloc( nBytes ); // 1x 16-bit channel: W
+        pRotatedTexels = (uint16_t*) Image_Alloc( nBytes ); // 1x 16-bit channel: W
         Image_Greyscale16bitRotateRight( gpGreyscaleTexels, gnWidth, gnHeight, pRotatedTexels );
 
         int t = gnWidth;
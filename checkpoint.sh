@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# Checkpoint and resume: render once straight through, then render again with a
+# checkpoint every 3 seconds, kill it part way and resume from the checkpoint.
+# The two raws must be identical.
+# Usage: checkpoint.sh [seconds before the kill]
+
+T=${1:-10}
+
+mkdir -p checkpoint
+cd       checkpoint
+
+rm -f resume.ckp resume.ckp.tmp
+
+echo "Uninterrupted ..."
+../bin/omp4 -raw whole.data --no-bmp 1024 768 2000 4 | grep "pix/s"
+
+echo "Killed after $T s ..."
+../bin/omp4 -checkpoint0.05 resume.ckp -raw resume.data --no-bmp 1024 768 2000 4 > /dev/null &
+sleep $T
+kill -9 $!
+wait $! 2> /dev/null
+
+echo "Resumed ..."
+../bin/omp4 -checkpoint0.05 resume.ckp --resume resume.ckp -raw resume.data --no-bmp | grep "^Resume\|^Checkpoint:.*saved\|pix/s"
+
+echo "Comparing raw images ..."
+cmp whole.data resume.data && echo "Identical"
+
+cd ..
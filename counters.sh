@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# 16-bit vs. 8-bit per-thread copies (-u8) across image sizes and densities.
+# 8-bit copies halve the footprint, so they pull ahead once the 16-bit copy
+# stops fitting in cache (1024x768 is 1.5 MB 16-bit, 0.75 MB 8-bit); on small,
+# dense images most deposits carry past 255 and the overflow log costs more
+# than it saves. "Overflow" is the number of counters that were spilled.
+# Usage: counters.sh [threads]
+
+J=${1:-$(grep -c ^processor /proc/cpuinfo)}
+SEEDS="-simd -orbit -j$J --no-rot"
+
+mkdir -p counters
+cd       counters
+
+for samples in 5M 40M; do
+    for size in "320 240" "1024 768" "2048 1536" "4000 3000" "8000 6000"; do
+        for policy in "" "-u8"; do
+            echo "$samples $size ${policy:-16-bit}"
+            ../bin/omp4 $SEEDS -random$samples $policy -raw counters.data -bmp counters.bmp $size 1000 1 | grep "pix/s\|Overflow\|Gather"
+        done
+        echo ""
+    done
+done
+
+cd ..
@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# Grid row order for the cost schedule at 1 .. N threads on the default 1024x768 grid:
+# grid order, longest job first from the escape pass estimate, and longest job
+# first from the cost map the previous run measured.
+# "in the last 10%" is the share of the threads still busy over the last 10% of the scatter.
+# Usage: ljf.sh [max threads]
+
+N=${1:-$(grep -c ^processor /proc/cpuinfo)}
+
+mkdir -p ljf
+cd       ljf
+
+rm -f ljf.cost
+../bin/omp4 -costmap ljf.cost --no-bmp --no-raw > /dev/null
+
+for (( j = 1; j <= N; j *= 2 )); do
+    for order in rows ljf; do
+        echo "-order $order -j$j"
+        ../bin/omp4 -order $order -j$j -raw ljf.data -bmp ljf.bmp | grep "pix/s\|^Schedule"
+    done
+
+    echo "-costmap -j$j"
+    ../bin/omp4 -costmap ljf.cost -j$j -raw ljf.data -bmp ljf.bmp | grep "pix/s\|^Schedule"
+    echo ""
+done
+
+cd ..
@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# NUMA scaling: all cores with and without pinning, and 1 thread for the baseline.
+# Buffers are always first-touched by their own thread; -pin / -pinnode also keep
+# each thread on the node its buffers landed on.
+# Usage: numa.sh [width height depth scale]
+
+CORES=$(grep -c ^processor /proc/cpuinfo)
+SIZE=${@:-6000 4500 1000 1}
+
+mkdir -p numa
+cd       numa
+
+for run in "-j1" "-j$CORES" "-j$CORES -pin" "-j$CORES -pinnode"; do
+    echo "$run"
+    ../bin/omp4 -simd $run -raw numa.data -bmp numa.bmp $SIZE | grep "NUMA\|Gather\|pix/s"
+    echo ""
+done
+
+cd ..
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+# Seed loop schedules at 1 .. N threads on the default 1024x768 grid.
+# "busy" is the share of threads x wall time spent iterating seeds; with one
+# core per thread the scatter scales by threads x busy.
+# Usage: schedule.sh [max threads]
+
+N=${1:-$(grep -c ^processor /proc/cpuinfo)}
+
+mkdir -p schedule
+cd       schedule
+
+for sched in static guided cost; do
+    for (( j = 1; j <= N; j *= 2 )); do
+        echo "$sched -j$j"
+        ../bin/omp4 -sched $sched -j$j -raw schedule.data -bmp schedule.bmp | grep "pix/s\|^Schedule"
+    done
+    echo ""
+done
+
+cd ..
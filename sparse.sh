@@ -0,0 +1,22 @@
+#!/bin/bash
+
+# Dense 16-bit copies vs. sparse tiles vs. atomic as the view zooms in while
+# the seeds still come from the whole set. The deeper the zoom the fewer tiles
+# each thread touches; sparse tiles then allocate and gather only those.
+# Usage: sparse.sh [threads]
+
+J=${1:-$(grep -c ^processor /proc/cpuinfo)}
+SEEDS="-simd -orbit -random5M -j$J --no-rot --no-bmp -domain -2 2 -2 2"
+
+mkdir -p sparse
+cd       sparse
+
+for view in "-2 2 -2 2" "-0.8 -0.6 0.2 0.4" "-0.76 -0.74 0.1 0.12" "-0.751 -0.749 0.1 0.102"; do
+    for policy in "-copies" "-sparse" "-atomic"; do
+        echo "$view $policy"
+        ../bin/omp4 $SEEDS -world $view $policy -raw sparse.data 4000 4000 1000 1 | grep "pix/s\|Sparse\|Gather"
+    done
+    echo ""
+done
+
+cd ..
@@ -0,0 +1,25 @@
+#!/bin/bash
+
+# Depth thumbnails 256 .. 1M as one cumulative job:
+# each depth only continues the seeds still running at the previous depth
+# and adds their orbits to the previous raw image.
+
+WIDTH=${WIDTH:-400}
+HEIGHT=${HEIGHT:-300}
+MAXDEPTH=${MAXDEPTH:-1048576}
+FLAGS="-simd -cull16 -period --no-rot"
+
+mkdir -p thumbnails
+cd       thumbnails
+
+depth=256
+../bin/omp4 $FLAGS -pending $depth.pending -raw $depth.data -bmp ${WIDTH}x${HEIGHT}@$depth.bmp $WIDTH $HEIGHT $depth ; echo ""
+
+while [ $depth -lt $MAXDEPTH ]; do
+    prev=$depth
+    depth=$((depth * 2))
+    ../bin/omp4 $FLAGS -pending $depth.pending -extend $prev.pending $prev.data -raw $depth.data -bmp ${WIDTH}x${HEIGHT}@$depth.bmp $WIDTH $HEIGHT $depth ; echo ""
+    rm $prev.pending
+done
+
+cd ..
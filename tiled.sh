@@ -0,0 +1,23 @@
+#!/bin/bash
+
+# Deposit throughput of the row-major image vs. -tiled# layouts.
+# The same 10M random seeds at every size; the deposits are identical so the
+# M/s figures compare directly. Tiles would only pay if consecutive orbit points
+# landed near each other; this measures whether they do at each image size.
+# Usage: tiled.sh [threads]
+
+J=${1:-$(grep -c ^processor /proc/cpuinfo)}
+SEEDS="-simd -orbit -random10M -j$J --no-rot --no-bmp"
+
+mkdir -p tiled
+cd       tiled
+
+for size in "1024 768" "4000 3000" "8000 6000"; do
+    for layout in "" "-tiled4" "-tiled8" "-tiled16" "-tiled32"; do
+        echo "$size ${layout:-rows}"
+        ../bin/omp4 $SEEDS $layout -raw tiled.data $size 1000 1 | grep "Deposits"
+    done
+    echo ""
+done
+
+cd ..
@@ -0,0 +1,293 @@
+    // Interior culling
+    //
+    // Seeds inside the Mandelbrot set never escape so they never plot anything,
+    // yet each one costs the full max depth. These tests are exact, that is,
+    // they only ever say "interior" for points that really are in the set:
+    //
+    //   * Main cardioid (period 1), closed form
+    //   * Period 2 disc |c + 1| < 1/4, closed form
+    //   * Optional table of discs inscribed in the period 3..N bulbs
+    //
+    // The table covers the p/q bulbs attached to the main cardioid (period q)
+    // and to the period 2 disc (period 2q). Each bulb's nucleus is found with
+    // Newton's method, then its boundary is traced by solving for the c where
+    // the attracting cycle has multiplier e^(it). The largest disc centered on
+    // the nucleus that doesn't cross any traced boundary point is kept, less a
+    // safety margin for the gaps between boundary samples.
+
+    #include <complex>
+
+    typedef std::complex<double> Complex;
+
+    struct InteriorDisc
+    {
+        double x, y; // center = nucleus
+        double rr  ; // radius^2
+    };
+
+    const int    MAX_INTERIOR_DISCS    = 512;
+    const int    INTERIOR_SAMPLES      = 257;  // boundary samples per bulb, odd so we never solve for multiplier = 1 exactly
+    const double INTERIOR_MARGIN       = 0.95; // fraction of nucleus to boundary distance we trust
+
+    InteriorDisc gaInteriorDiscs[ MAX_INTERIOR_DISCS ];
+    int          gnInteriorDiscs       = 0;
+    double       gaInteriorBounds[ 4 ] = { 0., 0., 0., 0. }; // min x, max x, min y, max y of all discs
+
+
+// ========================================================================
+inline bool Interior_Cardioid( const double x, const double y )
+{
+    const double a = x - 0.25;
+    const double q = a*a + y*y;
+    return (q * (q + a)) < (0.25 * y*y);
+}
+
+
+// ========================================================================
+inline bool Interior_Period2( const double x, const double y )
+{
+    const double a = x + 1.0;
+    return (a*a + y*y) < (1.0 / 16.0);
+}
+
+
+// ========================================================================
+inline bool Interior_Table( const double x, const double y )
+{
+    if( (x < gaInteriorBounds[0]) || (x > gaInteriorBounds[1])
+    ||  (y < gaInteriorBounds[2]) || (y > gaInteriorBounds[3]) )
+        return false;
+
+    for( int iDisc = 0; iDisc < gnInteriorDiscs; iDisc++ )
+    {
+        const InteriorDisc &disc = gaInteriorDiscs[ iDisc ];
+        const double dx = x - disc.x;
+        const double dy = y - disc.y;
+        if( (dx*dx + dy*dy) < disc.rr )
+            return true;
+    }
+
+    return false;
+}
+
+
+// @return true if the seed is known to be inside the set
+// ========================================================================
+inline bool Interior( const double x, const double y )
+{
+    return Interior_Cardioid( x, y )
+        || Interior_Period2 ( x, y )
+        || Interior_Table   ( x, y );
+}
+
+
+// Newton's method on f^n(0; c) = 0
+// @param c_ In: initial guess Out: nucleus of exact period n
+// ========================================================================
+bool Interior_FindNucleus( Complex &c_, const int period )
+{
+    bool bConverged = false;
+
+    for( int iter = 0; iter < 64 && !bConverged; iter++ )
+    {
+        Complex z  = 0.;
+        Complex dc = 0.; // d z / d c
+
+        for( int k = 0; k < period; k++ )
+        {
+            dc = 2.0*z*dc + 1.0;
+            z  = z*z + c_;
+        }
+
+        if( std::abs( dc ) == 0. )
+            return false;
+
+        const Complex step = z / dc;
+        c_ -= step;
+        bConverged = std::abs( step ) < 1e-15;
+    }
+
+    if( !bConverged )
+        return false;
+
+    // Reject nuclei of a lower period that divides n
+    Complex z = 0.;
+    for( int k = 1; k < period; k++ )
+    {
+        z = z*z + c_;
+        if( std::abs( z ) < 1e-9 )
+            return false;
+    }
+
+    return true;
+}
+
+
+// Newton's method on f^n(z; c) = z, (f^n)'(z; c) = multiplier
+// @param z_ In: guess Out: point on the cycle
+// @param c_ In: guess Out: parameter with that cycle multiplier
+// ========================================================================
+bool Interior_FindMultiplier( Complex &z_, Complex &c_, const int period, const Complex multiplier )
+{
+    for( int iter = 0; iter < 64; iter++ )
+    {
+        Complex z    = z_;
+        Complex dz   = 1.; // d  f^n / dz
+        Complex dc   = 0.; // d  f^n / dc
+        Complex dzz  = 0.; // d2 f^n / dz dz
+        Complex dzc  = 0.; // d2 f^n / dz dc
+
+        for( int k = 0; k < period; k++ )
+        {
+            dzz = 2.0*(dz*dz + z*dzz);
+            dzc = 2.0*(dc*dz + z*dzc);
+            dz  = 2.0*z*dz;
+            dc  = 2.0*z*dc + 1.0;
+            z   = z*z + c_;
+        }
+
+        const Complex f1  = z  - z_;
+        const Complex f2  = dz - multiplier;
+        const Complex a   = dz - 1.0; // [ a b ] Jacobian
+        const Complex b   = dc;       // [ e d ]
+        const Complex e   = dzz;
+        const Complex d   = dzc;
+        const Complex det = a*d - b*e;
+
+        if( std::abs( det ) == 0. )
+            return false;
+
+        const Complex stepZ = (d*f1 - b*f2) / det;
+        const Complex stepC = (a*f2 - e*f1) / det;
+
+        z_ -= stepZ;
+        c_ -= stepC;
+
+        if( std::abs( stepZ ) + std::abs( stepC ) < 1e-14 )
+            return true;
+    }
+
+    return false;
+}
+
+
+// @param guess  approximate nucleus
+// @param scale  approximate bulb radius; guesses that wander further are rejected
+// ========================================================================
+void Interior_AddBulb( Complex guess, const int period, const double scale )
+{
+    if( gnInteriorDiscs + 2 > MAX_INTERIOR_DISCS )
+        return;
+
+    Complex nucleus = guess;
+    if( !Interior_FindNucleus( nucleus, period ) )
+        return;
+
+    if( std::abs( nucleus - guess ) > scale )
+        return;
+
+    if( fabs( nucleus.imag() ) < 1e-12 ) // real axis
+        nucleus = Complex( nucleus.real(), 0. );
+
+    // Walk out from the nucleus (multiplier 0) to the boundary (|multiplier| = 1) at angle pi ...
+    const double PI = 3.141592653589793;
+    Complex z = 0.;
+    Complex c = nucleus;
+
+    for( int step = 1; step <= 8; step++ )
+        if( !Interior_FindMultiplier( z, c, period, std::polar( step / 8.0, PI ) ) )
+            return;
+
+    // ... then around it
+    double nMinDist = std::abs( c - nucleus );
+
+    for( int iSample = 1; iSample < INTERIOR_SAMPLES; iSample++ )
+    {
+        const double t = PI + (2.0 * PI * iSample) / INTERIOR_SAMPLES;
+        if( !Interior_FindMultiplier( z, c, period, std::polar( 1.0, t ) ) )
+            return;
+
+        const double dist = std::abs( c - nucleus );
+        if( nMinDist > dist )
+            nMinDist = dist;
+    }
+
+    const double r = INTERIOR_MARGIN * nMinDist;
+    if( r <= 0. )
+        return;
+
+    // Bulbs are symmetric about the real axis
+    for( int iMirror = 0; iMirror < 2; iMirror++ )
+    {
+        const double y = iMirror ? -nucleus.imag() : nucleus.imag();
+        if( iMirror && (y == nucleus.imag()) )
+            break;
+
+        InteriorDisc &disc = gaInteriorDiscs[ gnInteriorDiscs++ ];
+        disc.x  = nucleus.real();
+        disc.y  = y;
+        disc.rr = r * r;
+
+        if( gnInteriorDiscs == 1 )
+        {
+            gaInteriorBounds[0] = disc.x - r; gaInteriorBounds[1] = disc.x + r;
+            gaInteriorBounds[2] = disc.y - r; gaInteriorBounds[3] = disc.y + r;
+        }
+        if( gaInteriorBounds[0] > disc.x - r ) gaInteriorBounds[0] = disc.x - r;
+        if( gaInteriorBounds[1] < disc.x + r ) gaInteriorBounds[1] = disc.x + r;
+        if( gaInteriorBounds[2] > disc.y - r ) gaInteriorBounds[2] = disc.y - r;
+        if( gaInteriorBounds[3] < disc.y + r ) gaInteriorBounds[3] = disc.y + r;
+    }
+}
+
+
+// Build the table of bulbs with period 3 .. maxPeriod
+// @return number of discs in the table
+// ========================================================================
+int Interior_BuildTable( const int maxPeriod )
+{
+    const double PI = 3.141592653589793;
+    gnInteriorDiscs = 0;
+
+    for( int q = 2; q <= maxPeriod; q++ )
+    {
+        for( int p = 1; 2*p <= q; p++ )
+        {
+            int a = p, b = q; // gcd( p, q ) == 1
+            while( b ) { int t = a % b; a = b; b = t; }
+            if( a != 1 )
+                continue;
+
+            const Complex lambda = std::polar( 1.0, 2.0 * PI * p / q ); // multiplier at the bulb's root
+            const Complex inward = std::polar( 0.8, 2.0 * PI * p / q );
+            const double  radius = sin( PI * p / q ) / (q * q);
+
+            // p/q bulb on the main cardioid: c = lambda/2 - lambda^2/4
+            if( q >= 3 )
+            {
+                const Complex root  = lambda/2.0 - lambda*lambda/4.0;
+                const Complex dir   = root - (inward/2.0 - inward*inward/4.0);
+                Interior_AddBulb( root + (dir / std::abs( dir )) * radius, q, radius );
+            }
+
+            // p/q bulb on the period 2 disc: c = -1 + lambda/4
+            if( 2*q <= maxPeriod )
+            {
+                const Complex root  = -1.0 + lambda/4.0;
+                const Complex dir   = root - (-1.0 + inward/4.0);
+                Interior_AddBulb( root + (dir / std::abs( dir )) * (radius / 4.0), 2*q, radius / 4.0 );
+            }
+        }
+    }
+
+    // Biggest discs first so the common hits exit the search early
+    for( int i = 1; i < gnInteriorDiscs; i++ )
+        for( int j = i; j > 0 && gaInteriorDiscs[ j-1 ].rr < gaInteriorDiscs[ j ].rr; j-- )
+        {
+            InteriorDisc t = gaInteriorDiscs[ j-1 ];
+            gaInteriorDiscs[ j-1 ] = gaInteriorDiscs[ j ];
+            gaInteriorDiscs[ j   ] = t;
+        }
+
+    return gnInteriorDiscs;
+}
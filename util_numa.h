@@ -0,0 +1,156 @@
+    // NUMA topology and thread pinning
+    //
+    // The topology comes from /sys/devices/system/node/node#/cpulist so there is
+    // no libnuma dependency. Anywhere else (or without sysfs) every CPU is node 0
+    // and pinning is a no-op.
+    //
+    // Pages land on the node of the thread that first writes them, so a buffer
+    // that one thread mostly uses should be zeroed by that thread, not by main().
+
+#if defined(__linux__)
+    #include <sched.h> // sched_setaffinity() sched_getcpu()
+#endif
+
+    const int MAX_CPUS  = 1024;
+    const int MAX_NODES =   64;
+
+    enum Pin_e
+    {
+         PIN_NONE = 0 // leave threads to the OS
+        ,PIN_CORE     // thread i on the i'th allowed CPU, node by node
+        ,PIN_NODE     // threads split into contiguous blocks, one per node, free to move within it
+        ,NUM_PIN
+    };
+
+    const char *gaPinName[ NUM_PIN ] =
+    {
+         "OFF"
+        ,"core"
+        ,"node"
+    };
+
+    int gnNumaNodes              = 1;
+    int gaNumaCpuNode[ MAX_CPUS ];     // [ cpu ] node
+    int gnNumaCpus               = 0;  // CPUs this process may run on ...
+    int gaNumaCpus   [ MAX_CPUS ];     // ... sorted by node
+
+
+// @return node # of a cpu, 0 if unknown
+// ========================================================================
+inline int Numa_NodeOfCpu( const int cpu )
+{
+    return ((cpu >= 0) && (cpu < MAX_CPUS)) ? gaNumaCpuNode[ cpu ] : 0;
+}
+
+
+// @return node # the calling thread is running on
+// ========================================================================
+inline int Numa_CurrentNode()
+{
+#if defined(__linux__)
+    return Numa_NodeOfCpu( sched_getcpu() );
+#else
+    return 0;
+#endif
+}
+
+
+// Parse a sysfs cpu list such as "0-7,16-23" into the node table
+// ========================================================================
+void Numa_ParseCpuList( const char *list, const int node )
+{
+    while( *list )
+    {
+        char *end;
+        const long first = strtol( list, &end, 10 );
+        if( end == list )
+            break;
+
+        long last = first;
+        if( *end == '-' )
+            last = strtol( end + 1, &end, 10 );
+
+        for( long cpu = first; cpu <= last; cpu++ )
+            if( (cpu >= 0) && (cpu < MAX_CPUS) )
+                gaNumaCpuNode[ cpu ] = node;
+
+        list = (*end == ',') ? end + 1 : end;
+        if( *list == '\n' )
+            break;
+    }
+}
+
+
+// @return number of NUMA nodes
+// ========================================================================
+int Numa_Init()
+{
+    gnNumaNodes = 1;
+    gnNumaCpus  = 0;
+    memset( gaNumaCpuNode, 0, sizeof( gaNumaCpuNode ) );
+
+#if defined(__linux__)
+    for( int iNode = 0; iNode < MAX_NODES; iNode++ )
+    {
+        char path[ 64 ];
+        snprintf( path, sizeof( path ), "/sys/devices/system/node/node%d/cpulist", iNode );
+
+        FILE *file = fopen( path, "r" );
+        if( !file )
+            continue; // node #s can have holes
+
+        char list[ 4096 ];
+        if( fgets( list, sizeof( list ), file ) )
+            Numa_ParseCpuList( list, iNode );
+        fclose( file );
+
+        if( gnNumaNodes < iNode + 1 )
+            gnNumaNodes = iNode + 1;
+    }
+
+    cpu_set_t allowed;
+    CPU_ZERO( &allowed );
+    if( sched_getaffinity( 0, sizeof( allowed ), &allowed ) == 0 )
+    {
+        for( int iNode = 0; iNode < gnNumaNodes; iNode++ )
+            for( int cpu = 0; cpu < MAX_CPUS && cpu < CPU_SETSIZE; cpu++ )
+                if( CPU_ISSET( cpu, &allowed ) && (gaNumaCpuNode[ cpu ] == iNode) )
+                    gaNumaCpus[ gnNumaCpus++ ] = cpu;
+    }
+#endif
+
+    return gnNumaNodes;
+}
+
+
+// Pin the calling thread
+// @return false if the OS refused or pinning isn't supported
+// ========================================================================
+bool Numa_Pin( const int iThread, const int nThreads, const int pin )
+{
+#if defined(__linux__)
+    if( (pin == PIN_NONE) || !gnNumaCpus )
+        return false;
+
+    // Thread i takes CPU i, or the node of CPU i * cpus / threads when spreading over nodes
+    const int iCpu = (pin == PIN_CORE)
+        ? iThread % gnNumaCpus
+        : (int)(((int64_t) iThread * gnNumaCpus) / nThreads);
+    const int node = gaNumaCpuNode[ gaNumaCpus[ iCpu ] ];
+
+    cpu_set_t set;
+    CPU_ZERO( &set );
+
+    if( pin == PIN_CORE )
+        CPU_SET( gaNumaCpus[ iCpu ], &set );
+    else
+        for( int i = 0; i < gnNumaCpus; i++ )
+            if( gaNumaCpuNode[ gaNumaCpus[ i ] ] == node )
+                CPU_SET( gaNumaCpus[ i ], &set );
+
+    return sched_setaffinity( 0, sizeof( set ), &set ) == 0;
+#else
+    (void) iThread; (void) nThreads; (void) pin;
+    return false;
+#endif
+}
@@ -0,0 +1,125 @@
+    // Progress: per-thread counters sampled by a reporter thread
+    //
+    // Each worker only ever adds to its own counter, on its own cache line, with a
+    // relaxed load and store -- no atomic read-modify-write, no shared counter,
+    // and no printing on the hot path. A separate low priority thread wakes every
+    // PROGRESS_INTERVAL seconds, sums the counters and prints percent, rate and ETA.
+    // Needs MAX_THREADS from util_threads.h
+
+    #include <atomic>
+    #include <chrono>
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+#if defined(__linux__)
+    #include <sys/resource.h> // setpriority()
+    #include <sys/syscall.h>  // SYS_gettid
+    #include <unistd.h>
+#endif
+
+    struct alignas(64) ProgressCounter
+    {
+        std::atomic<uint64_t> n;
+    };
+
+    const int                PROGRESS_INTERVAL_MS = 500;
+    ProgressCounter          gaProgress[ MAX_THREADS ];
+    int                      gnProgressThreads = 0;
+    uint64_t                 gnProgressTotal   = 0; // 100%
+    std::chrono::steady_clock::time_point gProgressStart;
+
+    std::thread              gProgressReporter;
+    std::mutex               gProgressMutex;
+    std::condition_variable  gProgressWake;
+    bool                     gbProgressStop    = false;
+
+
+// Hot path: count n more units done by thread iTid
+// ========================================================================
+inline void Progress_Add( const int iTid, const uint64_t n )
+{
+    std::atomic<uint64_t> &counter = gaProgress[ iTid ].n;
+    counter.store( counter.load( std::memory_order_relaxed ) + n, std::memory_order_relaxed );
+}
+
+
+// @return units done by all threads so far
+// ========================================================================
+uint64_t Progress_Done()
+{
+    uint64_t n = 0;
+    for( int iThread = 0; iThread < gnProgressThreads; iThread++ )
+        n += gaProgress[ iThread ].n.load( std::memory_order_relaxed );
+    return n;
+}
+
+
+// ========================================================================
+void Progress_Print( const bool bFinal )
+{
+    const uint64_t n       = Progress_Done();
+    const double   elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - gProgressStart ).count();
+    const double   rate    = (elapsed > 0.) ? n / elapsed : 0.;
+    const double   percent = gnProgressTotal ? (100.0 * n) / gnProgressTotal : 100.;
+    const int      eta     = ((rate > 0.) && (n < gnProgressTotal)) ? (int)((gnProgressTotal - n) / rate) : 0;
+
+    printf( "\r%6.2f%% = %llu / %llu, %.2f M/s, ETA %02d:%02d:%02d   %s"
+        , percent, (unsigned long long) n, (unsigned long long) gnProgressTotal, rate / 1e6
+        , eta / 3600, (eta / 60) % 60, eta % 60
+        , bFinal ? "\n" : "" );
+    fflush( stdout );
+}
+
+
+// Reporter thread
+// ========================================================================
+void Progress_Report()
+{
+#if defined(__linux__)
+    setpriority( PRIO_PROCESS, (id_t) syscall( SYS_gettid ), 19 ); // nice: only this thread on Linux
+#endif
+
+    std::unique_lock<std::mutex> lock( gProgressMutex );
+    while( !gbProgressStop )
+    {
+        gProgressWake.wait_for( lock, std::chrono::milliseconds( PROGRESS_INTERVAL_MS ) );
+        if( !gbProgressStop )
+            Progress_Print( false );
+    }
+}
+
+
+// Zero the counters of nThreads workers; nTotal units is 100%
+// @param bReport start the reporter thread
+// ========================================================================
+void Progress_Start( const uint64_t nTotal, const int nThreads, const bool bReport )
+{
+    for( int iThread = 0; iThread < nThreads; iThread++ )
+        gaProgress[ iThread ].n.store( 0, std::memory_order_relaxed );
+
+    gnProgressThreads = nThreads;
+    gnProgressTotal   = nTotal;
+    gProgressStart    = std::chrono::steady_clock::now();
+    gbProgressStop    = false;
+
+    if( bReport )
+        gProgressReporter = std::thread( Progress_Report );
+}
+
+
+// Stop the reporter, if any, after a final report
+// ========================================================================
+void Progress_Stop()
+{
+    if( !gProgressReporter.joinable() )
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock( gProgressMutex );
+        gbProgressStop = true;
+    }
+    gProgressWake.notify_one();
+    gProgressReporter.join();
+
+    Progress_Print( true );
+}
@@ -0,0 +1,98 @@
+    // Counter-based random numbers: Philox4x32-10
+    //   Salmon, Moraes, Dror, Shaw, "Parallel Random Numbers: As Easy as 1, 2, 3", SC11
+    //
+    // There is no generator state to share or split between threads: sample #n is
+    // always the same function of (n, key) no matter which thread draws it, in what
+    // order, or how the samples are chunked -- so -j1 and -j8 produce the same image.
+
+    const uint32_t PHILOX_M0 = 0xD2511F53;
+    const uint32_t PHILOX_M1 = 0xCD9E8D57;
+    const uint32_t PHILOX_W0 = 0x9E3779B9; // golden ratio
+    const uint32_t PHILOX_W1 = 0xBB67AE85; // sqrt(3) - 1
+
+    struct Philox4x32
+    {
+        uint32_t v[4];
+    };
+
+
+// ========================================================================
+inline Philox4x32 Philox( uint64_t counter, uint64_t key )
+{
+    Philox4x32 c;
+    c.v[0] = (uint32_t)(counter      );
+    c.v[1] = (uint32_t)(counter >> 32);
+    c.v[2] = 0;
+    c.v[3] = 0;
+
+    uint32_t k0 = (uint32_t)(key      );
+    uint32_t k1 = (uint32_t)(key >> 32);
+
+    for( int round = 0; round < 10; round++ )
+    {
+        const uint64_t p0 = (uint64_t)PHILOX_M0 * c.v[0];
+        const uint64_t p1 = (uint64_t)PHILOX_M1 * c.v[2];
+
+        const uint32_t hi0 = (uint32_t)(p0 >> 32), lo0 = (uint32_t)p0;
+        const uint32_t hi1 = (uint32_t)(p1 >> 32), lo1 = (uint32_t)p1;
+
+        c.v[0] = hi1 ^ c.v[1] ^ k0;
+        c.v[1] = lo1;
+        c.v[2] = hi0 ^ c.v[3] ^ k1;
+        c.v[3] = lo0;
+
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    return c;
+}
+
+
+// Two uniform doubles in [0,1) with 53 bits each for sample #counter
+// ========================================================================
+inline void Philox_Uniform2( const uint64_t counter, const uint64_t key, double *u_, double *v_ )
+{
+    const Philox4x32 c = Philox( counter, key );
+    const uint64_t   a = ((uint64_t)c.v[0] << 32) | c.v[1];
+    const uint64_t   b = ((uint64_t)c.v[2] << 32) | c.v[3];
+
+    const double scale = 1.0 / 9007199254740992.0; // 2^-53
+    *u_ = (a >> 11) * scale;
+    *v_ = (b >> 11) * scale;
+}
+
+
+// Quasi-random numbers: 2D Sobol sequence
+//
+// Point #n is computed directly from n (no state), so any contiguous range of
+// indices can be drawn by any thread. Dimension 1 is the van der Corput
+// sequence (bit reversal of n); dimension 2 uses the direction numbers of the
+// primitive polynomial x + 1: v[0] = 1/2, v[k] = v[k-1] ^ (v[k-1] >> 1).
+// The shift is XORed onto both coordinates (a digital shift), which keeps the
+// low discrepancy but moves the points off the domain edges and lets -rng
+// pick an independent point set.
+// ========================================================================
+inline void Sobol_Uniform2( uint64_t counter, const uint64_t shiftU, const uint64_t shiftV, double *u_, double *v_ )
+{
+    uint64_t a = 0;
+    uint64_t b = 0;
+    uint64_t v = 1ULL << 63;
+
+    for( int bit = 63; counter; bit--, counter >>= 1 )
+    {
+        if( counter & 1 )
+        {
+            a ^= 1ULL << bit;
+            b ^= v;
+        }
+        v ^= v >> 1;
+    }
+
+    a ^= shiftU;
+    b ^= shiftV;
+
+    const double scale = 1.0 / 9007199254740992.0; // 2^-53
+    *u_ = (a >> 11) * scale;
+    *v_ = (b >> 11) * scale;
+}
@@ -9,6 +9,7 @@ echo -e "\nMulti-threaded v2 ...    " ; ../bin/omp2       -raw omp2.data
 echo -e "\nMulti-threaded v3 ...    " ; ../bin/omp3       -raw omp3.data
 echo -e "\nMulti-threaded v3 float32" ; ../bin/omp3float  -raw omp3float.data
 echo -e "\nMulti-threaded v4 ...    " ; ../bin/omp4       -raw omp4.data
+echo -e "\nMulti-threaded v4 SIMD   " ; ../bin/omp4 -simd -raw omp4simd.data
 
 echo -e "\nComparing raw images ..."
 
@@ -23,3 +24,5 @@ diff "omp3.data" "omp3float.data"
 echo -e "\bCompare two Fastest verions v3 and v4"
 diff "omp3.data" "omp4.data"
 
+echo -e "\nCompare v4 scalar with v4 SIMD"
+diff "omp4.data" "omp4simd.data"